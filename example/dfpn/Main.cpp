@@ -18,6 +18,9 @@ static const size_t         HashWindow       = 16;
 /// ハッシュサイズ
 static const size_t         HashSize         = 0x1000000ULL + HashWindow + 1;
 
+/// 証明済み局面テーブルサイズ (MiB)
+static const size_t         ProofSize        = 64;
+
 /// 手順最大記録数
 static const size_t         MaxDepth         = 5000;
 
@@ -36,6 +39,9 @@ std::string                 _sequence[MaxDepth];
 class HashEntry;
 static HashEntry *          _hash = nullptr;
 
+// 証明済み局面 (盤面と攻め方の持ち駒で引く)
+static HandTable<bool> *    _proof = nullptr;
+
 /* ------------------------------------------------------------------------- */
 
 /* --------------------------- HashEntry class ----------------------------- */
@@ -71,9 +77,11 @@ static void    resetHash      (void);
 // ハッシュ計測
 static void    countHash      (void);
 // ハッシュ登録
-static void    PutInHash      (Zobrist::key, CN<int>,   CN<int>  );
+static void    PutInHash      (const Position &, CN<int>,   CN<int>  );
 // ハッシュ検索
-static void    LookUpHash     (Zobrist::key, CN<int> &, CN<int> &);
+static void    LookUpHash     (const Position &, CN<int> &, CN<int> &);
+// 証明済み局面のキー
+static Zobrist::key proofKey  (const Position &);
 
 // 手を記録する
 static void    recordMove     (int, std::string);
@@ -110,6 +118,8 @@ static void initHash (void)
 
     _hash = new HashEntry[HashSize];
 
+    _proof = new HandTable<bool>(ProofSize);
+
     std::cout << "Hash Size : "
               << ((HashSize * sizeof(HashEntry)) >> 20) << "MiB" << std::endl;
 
@@ -127,6 +137,8 @@ static void clearHash (void)
         _hash[i].key = 0;
     }
 
+    _proof->clear();
+
 }
 
 /**
@@ -164,15 +176,34 @@ static void countHash (void)
 
 }
 
+/**
+ * 証明済み局面のキー
+ * 盤面が同じでも手番が異なる局面は区別する
+ * @parm p 局面
+ * @return 盤面のハッシュキー
+ */
+static Zobrist::key proofKey (const Position &p)
+{
+
+    return p.hashBoard() + p.turn();
+
+}
+
 /**
  * ハッシュ登録
- * @parm key ハッシュキー
+ * @parm p   局面
  * @parm pn  証明数
  * @parm dn  反証数
  */
-static void PutInHash (Zobrist::key key, CN<int> pn, CN<int> dn)
+static void PutInHash (const Position &p, CN<int> pn, CN<int> dn)
 {
 
+    // 詰みが証明された局面は持ち駒の優越関係で引けるように登録
+    if (! pn.isinf() && ! (pn != 0)) {
+        _proof->store(proofKey(p), p.hand(Color::Black), true);
+    }
+
+    auto   key = p.hash();
     size_t idx = HashEntry::index(key);
     size_t i;
 
@@ -198,13 +229,14 @@ static void PutInHash (Zobrist::key key, CN<int> pn, CN<int> dn)
 
 /**
  * ハッシュ検索
- * @parm key ハッシュキー
+ * @parm p   局面
  * @parm pn  証明数
  * @parm dn  反証数
  */
-static void LookUpHash (Zobrist::key key, CN<int> &pn, CN<int> &dn)
+static void LookUpHash (const Position &p, CN<int> &pn, CN<int> &dn)
 {
 
+    auto   key = p.hash();
     size_t idx = HashEntry::index(key);
 
     for (size_t i = 0; i < HashWindow; ++i, ++idx) {
@@ -215,6 +247,15 @@ static void LookUpHash (Zobrist::key key, CN<int> &pn, CN<int> &dn)
         }
     }
 
+    // 同じ盤面で攻め方の持ち駒が劣る局面が詰みならこの局面も詰み
+    bool proven;
+    if (_proof->inferior(proofKey(p), p.hand(Color::Black),
+                         [] (bool) { return true; }, proven)) {
+        pn = 0;
+        dn.infinity();
+        return;
+    }
+
     pn = 1;
     dn = 1;
 
@@ -271,7 +312,7 @@ static size_t SelectChildOr (Position &p, Array<Move::Move, Move::Max> &m,
 
         // ハッシュ検索
         CN<int> _pn, _dn;
-        LookUpHash(p.hash(), _pn, _dn);
+        LookUpHash(p, _pn, _dn);
 
         // 局面を戻す
         p.undo(back);
@@ -316,7 +357,7 @@ static size_t SelectChildAnd (Position &p, Array<Move::Move, Move::Max> &m,
 
         // ハッシュ検索
         CN<int> _pn, _dn;
-        LookUpHash(p.hash(), _pn, _dn);
+        LookUpHash(p, _pn, _dn);
 
         // 局面を戻す
         p.undo(back);
@@ -354,7 +395,7 @@ static CN<int> DeltaMinOr (Position &p, Array<Move::Move, Move::Max> &m)
 
         // ハッシュ検索
         CN<int> _pn, _dn;
-        LookUpHash(p.hash(), _pn, _dn);
+        LookUpHash(p, _pn, _dn);
 
         // 局面を戻す
         p.undo(back);
@@ -384,7 +425,7 @@ static CN<int> DeltaMinAnd (Position &p, Array<Move::Move, Move::Max> &m)
 
         // ハッシュ検索
         CN<int> _pn, _dn;
-        LookUpHash(p.hash(), _pn, _dn);
+        LookUpHash(p, _pn, _dn);
 
         // 局面を戻す
         p.undo(back);
@@ -414,7 +455,7 @@ static CN<int> PhiSumOr (Position &p, Array<Move::Move, Move::Max> &m)
 
         // ハッシュ検索
         CN<int> _pn, _dn;
-        LookUpHash(p.hash(), _pn, _dn);
+        LookUpHash(p, _pn, _dn);
 
         // 局面を戻す
         p.undo(back);
@@ -444,7 +485,7 @@ static CN<int> PhiSumAnd (Position &p, Array<Move::Move, Move::Max> &m)
 
         // ハッシュ検索
         CN<int> _pn, _dn;
-        LookUpHash(p.hash(), _pn, _dn);
+        LookUpHash(p, _pn, _dn);
 
         // 局面を戻す
         p.undo(back);
@@ -469,7 +510,7 @@ static void MIDOr (Position &p, CN<int> &pn, CN<int> &dn, int dx)
 
     // 1. ハッシュを引く
     CN<int> _pn, _dn;
-    LookUpHash(p.hash(), _pn, _dn);
+    LookUpHash(p, _pn, _dn);
     if (pn <= _pn  || dn <= _dn ) {
         pn = _pn;
         dn = _dn;
@@ -488,12 +529,12 @@ static void MIDOr (Position &p, CN<int> &pn, CN<int> &dn, int dx)
     if (nmove == 0) {
         pn.infinity();
         dn = 0;
-        PutInHash(p.hash(), pn, dn);
+        PutInHash(p, pn, dn);
         return;
     }
 
     // 3. ハッシュによるサイクル回避
-    PutInHash(p.hash(), CN<int>(), CN<int>(0));
+    PutInHash(p, CN<int>(), CN<int>(0));
 
     // 4. 多重反復深化
     while (1) {
@@ -504,7 +545,7 @@ static void MIDOr (Position &p, CN<int> &pn, CN<int> &dn, int dx)
         if (pn <= dmin || dn <= psum) {
             pn = dmin;
             dn = psum;
-            PutInHash(p.hash(), pn, dn);
+            PutInHash(p, pn, dn);
             return;
         }
 
@@ -538,7 +579,7 @@ static void MIDAnd (Position &p, CN<int> &pn, CN<int> &dn, int dx)
 
     // 1. ハッシュを引く
     CN<int> _pn, _dn;
-    LookUpHash(p.hash(), _pn, _dn);
+    LookUpHash(p, _pn, _dn);
     if (pn <= _pn  || dn <= _dn ) {
         pn = _pn;
         dn = _dn;
@@ -563,12 +604,12 @@ static void MIDAnd (Position &p, CN<int> &pn, CN<int> &dn, int dx)
             pn = 0;
             dn.infinity();
         }
-        PutInHash(p.hash(), pn, dn);
+        PutInHash(p, pn, dn);
         return;
     }
 
     // 3. ハッシュによるサイクル回避
-    PutInHash(p.hash(), CN<int>(), CN<int>(0));
+    PutInHash(p, CN<int>(), CN<int>(0));
 
     // 4. 多重反復深化
     while (1) {
@@ -579,7 +620,7 @@ static void MIDAnd (Position &p, CN<int> &pn, CN<int> &dn, int dx)
         if (dn <= dmin || pn <= psum) {
             dn = dmin;
             pn = psum;
-            PutInHash(p.hash(), pn, dn);
+            PutInHash(p, pn, dn);
             return;
         }
 
@@ -41,6 +41,9 @@
 #ifndef _FOUNDATION_ARRAY_H
 #define _FOUNDATION_ARRAY_H
 
+#include <cstdint>
+#include <algorithm>
+
 // begin namespace 'foundation'
 namespace foundation {
 
@@ -104,11 +107,28 @@ public:
     /// Delete entry
     T           del    (void);
 
-    /// Sort in ascending order
-    void        acsort (void);
+    /// Number of elements sorted by insertion, more are sorted by std::sort
+    static constexpr size_t Insertion = 32;
+
+    /// Sort the elements from the index in ascending order
+    void        acsort (size_t = 0);
+
+    /// Sort the elements from the index in decending order
+    void        dcsort (size_t = 0);
+
+    /// Bring the smallest element from the index to the index
+    void        acpick (size_t);
 
-    /// Sort in decending order
-    void        dcsort (void);
+    /// Bring the largest element from the index to the index
+    void        dcpick (size_t);
+
+    /// Radix sort the elements from the index in ascending order
+    /// of the upper 16 bits (32-bit elements only)
+    void        rasort (size_t = 0);
+
+    /// Radix sort the elements from the index in decending order
+    /// of the upper 16 bits (32-bit elements only)
+    void        rdsort (size_t = 0);
 
     /// Check size
     size_t      size   (void) { return _reserve;    }
@@ -146,6 +166,9 @@ public:
 
 protected:
 
+    /// Radix sort by the upper 16 bits
+    void        _radix (size_t, bool);
+
     size_t      _reserve;
     size_t      _values;
     T           _ptr[Size];
@@ -196,35 +219,191 @@ T Array<T, Size>::del (void)
 }
 
 
+/**
+ * Sort the elements from the index in ascending order
+ * A short array is sorted by insertion, which keeps the order of the
+ * equal elements. A long one is sorted by std::sort, which does not.
+ * @param from index of the first element sorted
+ */
+template <typename T, const size_t Size>
+void Array<T, Size>::acsort (size_t from)
+{
+
+    if (from + Insertion < _values) {
+        std::sort(_ptr + from, _ptr + _values);
+        return;
+    }
+
+    for (size_t i = from + 1; i < _values; ++i) {
+        T               t = _ptr[i];
+        size_t          j = i;
+        for (; j > from && t < _ptr[j - 1]; --j) {
+            _ptr[j] = _ptr[j - 1];
+        }
+        _ptr[j] = t;
+    }
+
+}
+
+
+/**
+ * Sort the elements from the index in decending order
+ * A short array is sorted by insertion, which keeps the order of the
+ * equal elements. A long one is sorted by std::sort, which does not.
+ * @param from index of the first element sorted
+ */
+template <typename T, const size_t Size>
+void Array<T, Size>::dcsort (size_t from)
+{
+
+    if (from + Insertion < _values) {
+        std::sort(_ptr + from, _ptr + _values,
+                  [](const T &a, const T &b) { return a > b; });
+        return;
+    }
+
+    for (size_t i = from + 1; i < _values; ++i) {
+        T               t = _ptr[i];
+        size_t          j = i;
+        for (; j > from && t > _ptr[j - 1]; --j) {
+            _ptr[j] = _ptr[j - 1];
+        }
+        _ptr[j] = t;
+    }
+
+}
+
+
+/**
+ * Bring the smallest element from the index to the index
+ * Picking the elements one by one sorts only as many of them as taken
+ * (selection sort), which is cheaper than sorting all when the rest are
+ * likely to be thrown away.
+ * @param i index
+ */
+template <typename T, const size_t Size>
+void Array<T, Size>::acpick (size_t i)
+{
+
+    size_t              b = i;
+
+    for (size_t j = i + 1; j < _values; ++j) {
+        if (_ptr[j] < _ptr[b]) {
+            b = j;
+        }
+    }
+    if (b != i) {
+        T               t = _ptr[i];
+        _ptr[i] = _ptr[b];
+        _ptr[b] = t;
+    }
+
+}
+
+
+/**
+ * Bring the largest element from the index to the index
+ * Picking the elements one by one sorts only as many of them as taken
+ * (selection sort), which is cheaper than sorting all when the rest are
+ * likely to be thrown away.
+ * @param i index
+ */
 template <typename T, const size_t Size>
-void Array<T, Size>::acsort (void)
+void Array<T, Size>::dcpick (size_t i)
 {
 
-    for (int i = 0; i < static_cast<int>(_values - 1); ++i) {
-        for (int j = static_cast<int>(_values - 1); j > i; --j) {
-            if (_ptr[j] < _ptr[j - 1]) {
-                T         t = _ptr[  j  ];
-                _ptr[  j  ] = _ptr[j - 1];
-                _ptr[j - 1] = t;
-            }
+    size_t              b = i;
+
+    for (size_t j = i + 1; j < _values; ++j) {
+        if (_ptr[j] > _ptr[b]) {
+            b = j;
         }
     }
+    if (b != i) {
+        T               t = _ptr[i];
+        _ptr[i] = _ptr[b];
+        _ptr[b] = t;
+    }
+
+}
+
+
+/**
+ * Radix sort the elements from the index in ascending order of the upper
+ * 16 bits (the value of Move::Move)
+ * @param from index of the first element sorted
+ */
+template <typename T, const size_t Size>
+void Array<T, Size>::rasort (size_t from)
+{
+
+    _radix(from, false);
+
+}
+
+
+/**
+ * Radix sort the elements from the index in decending order of the upper
+ * 16 bits (the value of Move::Move)
+ * @param from index of the first element sorted
+ */
+template <typename T, const size_t Size>
+void Array<T, Size>::rdsort (size_t from)
+{
+
+    _radix(from, true);
 
 }
 
 
+/**
+ * Radix sort by the upper 16 bits
+ * Two passes of counting sort on 8 bits each (LSD), so the time is linear
+ * in the number of the elements and the order of the elements having the
+ * same upper bits is kept. A pass is skipped when all the elements fall in
+ * a bucket, which is often the case of the upper byte.
+ * @param from index of the first element sorted
+ * @param decending true to sort in decending order
+ */
 template <typename T, const size_t Size>
-void Array<T, Size>::dcsort (void)
+void Array<T, Size>::_radix (size_t from, bool decending)
 {
 
-    for (int i = 0; i < static_cast<int>(_values - 1); ++i) {
-        for (int j = static_cast<int>(_values - 1); j > i; --j) {
-            if (_ptr[j] > _ptr[j - 1]) {
-                T         t = _ptr[  j  ];
-                _ptr[  j  ] = _ptr[j - 1];
-                _ptr[j - 1] = t;
-            }
+    static_assert(sizeof(T) == sizeof(uint32_t), "32-bit elements only");
+
+    if (from + 1 >= _values) {
+        return;
+    }
+
+    size_t              n     = _values - from;
+    uint32_t            flip  = decending ? 0xff : 0;
+    T                   temp[Size];
+    T *                 src   = _ptr + from;
+    T *                 dst   = temp;
+
+    for (int shift = 16; shift < 32; shift += 8) {
+        auto            digit = [shift, flip](const T &x) {
+                                    return ((static_cast<uint32_t>(x) >> shift)
+                                            & 0xff) ^ flip;
+                                };
+        size_t          count[256 + 1] = {};
+        for (size_t i = 0; i < n; ++i) {
+            ++count[digit(src[i]) + 1];
+        }
+        if (count[digit(src[0]) + 1] == n) {
+            continue;
         }
+        for (int b = 0; b < 256; ++b) {
+            count[b + 1] += count[b];
+        }
+        for (size_t i = 0; i < n; ++i) {
+            dst[count[digit(src[i])]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != _ptr + from) {
+        std::copy(src, src + n, _ptr + from);
     }
 
 }
@@ -43,6 +43,8 @@
 #define _FOUNDATION_BITOPE_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include <immintrin.h>
 
 // begin namespace 'foundation::Bitope'
 namespace foundation { namespace Bitope {
@@ -70,6 +72,17 @@ namespace foundation { namespace Bitope {
 
 /* ------------------------- prototype declaration ------------------------- */
 
+/// Instruction sets for the batch operations
+enum SIMD {
+    Scalar       = 0,   /// POPCNT only
+    AVX2         = 1,   /// AVX2
+    AVX512       = 2,   /// AVX-512F and AVX-512BW
+    AVX512POPCNT = 3    /// AVX-512 with VPOPCNTQ (AVX512_VPOPCNTDQ)
+};
+
+/// Result of the batched LSB for a value with no bit set
+static const uint32_t       NoBit        = 128;
+
 /* ------------------------------------------------------------------------- */
 
 
@@ -208,6 +221,37 @@ inline uint32_t bsrr (uint64_t &v)
 
 
 
+/**
+ * TZCNT - count trailing zeros of the given 64 bit value.
+ * Unlike bsf() this is not a volatile asm, so that the compiler can
+ * schedule it in tight loops (tzcnt with BMI, bsf without it).
+ * The result won't be predictable if v is zero.
+ * @param  v value to be scanned.
+ * @return bit index.
+ */
+inline uint32_t tzcnt (uint64_t v)
+{
+
+    return static_cast<uint32_t>(__builtin_ctzll(v));
+
+}
+
+
+
+/**
+ * BLSR - reset the lowest set bit of the given 64 bit value.
+ * @param  v value
+ * @return v with LSB reset
+ */
+inline uint64_t blsr (uint64_t v)
+{
+
+    return v & (v - 1);
+
+}
+
+
+
 /**
  * POPCNT - count bits set in 128 bits data
  * @param  p1 
@@ -287,6 +331,445 @@ inline uint64_t pext (uint64_t v, uint64_t mask)
 
 /* ------------------------------------------------------------------------- */
 
+/* ---------------------------- batch operations --------------------------- */
+
+/*
+ * The batch operations work on an array of n 128-bit values, each of which
+ * is a pair of 64-bit words (v[2i], v[2i + 1]) like Bitboard::p. They take
+ * the widest instruction set the processor supports at runtime, unless
+ * it measured slower than the narrower one, and the functions for each
+ * instruction set are also exposed for benchmarking.
+ */
+
+/**
+ * Instruction set the batch operations take on this processor
+ * @return SIMD level
+ */
+inline SIMD simd (void)
+{
+
+    static const SIMD       level = [] () {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f" ) &&
+            __builtin_cpu_supports("avx512bw")   ) {
+            return __builtin_cpu_supports("avx512vpopcntdq") ?
+                                            AVX512POPCNT : AVX512;
+        }
+        return __builtin_cpu_supports("avx2") ? AVX2 : Scalar;
+    } ();
+
+    return level;
+
+}
+
+
+
+/**
+ * Population count of each 128-bit value (scalar)
+ * @param v array of 2n words
+ * @param n number of the 128-bit values
+ * @param r array of n results
+ */
+inline void popcntsScalar (const uint64_t *v, size_t n, uint32_t *r)
+{
+
+    for (size_t i = 0; i < n; ++i) {
+        r[i] = popcnt(v[2 * i], v[2 * i + 1]);
+    }
+
+}
+
+
+
+/**
+ * Population count of each 128-bit value (AVX2)
+ * Bytes are counted with a nibble table (vpshufb) and summed up into
+ * the 64-bit words by vpsadbw.
+ * @param v array of 2n words
+ * @param n number of the 128-bit values
+ * @param r array of n results
+ */
+__attribute__ ((target ("avx2")))
+inline void popcntsAVX2 (const uint64_t *v, size_t n, uint32_t *r)
+{
+
+    const __m256i           table = _mm256_setr_epi8(
+                                        0, 1, 1, 2, 1, 2, 2, 3,
+                                        1, 2, 2, 3, 2, 3, 3, 4,
+                                        0, 1, 1, 2, 1, 2, 2, 3,
+                                        1, 2, 2, 3, 2, 3, 3, 4 );
+    const __m256i           low   = _mm256_set1_epi8(0x0f);
+
+    size_t                  i     = 0;
+
+    // two values at a time
+    for (; i + 2 <= n; i += 2) {
+        __m256i x = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i *>(v + 2 * i));
+        __m256i c = _mm256_add_epi8(
+                        _mm256_shuffle_epi8(table, _mm256_and_si256(x, low)),
+                        _mm256_shuffle_epi8(table, _mm256_and_si256(
+                                            _mm256_srli_epi16(x, 4), low)));
+        c         = _mm256_sad_epu8(c, _mm256_setzero_si256());
+        c         = _mm256_add_epi64(c, _mm256_shuffle_epi32(c, 0x4e));
+        r[i    ]  = static_cast<uint32_t>(_mm256_extract_epi64(c, 0));
+        r[i + 1]  = static_cast<uint32_t>(_mm256_extract_epi64(c, 2));
+    }
+
+    popcntsScalar(v + 2 * i, n - i, r + i);
+
+}
+
+
+
+// The AVX-512 intrinsics of GCC start from _mm512_undefined_*() values
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+/**
+ * Population count of each 128-bit value (AVX-512)
+ * @param v array of 2n words
+ * @param n number of the 128-bit values
+ * @param r array of n results
+ */
+__attribute__ ((target ("avx512f,avx512bw")))
+inline void popcntsAVX512 (const uint64_t *v, size_t n, uint32_t *r)
+{
+
+    const __m512i           table = _mm512_broadcast_i32x4(_mm_setr_epi8(
+                                        0, 1, 1, 2, 1, 2, 2, 3,
+                                        1, 2, 2, 3, 2, 3, 3, 4 ));
+    const __m512i           low   = _mm512_set1_epi8(0x0f);
+
+    size_t                  i     = 0;
+
+    // four values at a time
+    for (; i + 4 <= n; i += 4) {
+        __m512i x = _mm512_loadu_si512(v + 2 * i);
+        __m512i c = _mm512_add_epi8(
+                        _mm512_shuffle_epi8(table, _mm512_and_si512(x, low)),
+                        _mm512_shuffle_epi8(table, _mm512_and_si512(
+                                            _mm512_srli_epi16(x, 4), low)));
+        c         = _mm512_sad_epu8(c, _mm512_setzero_si512());
+        c         = _mm512_add_epi64(c, _mm512_shuffle_epi32(c, _MM_PERM_BADC));
+        c         = _mm512_maskz_compress_epi64(0x55, c);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(r + i),
+                         _mm256_castsi256_si128(_mm512_cvtepi64_epi32(c)));
+    }
+
+    popcntsScalar(v + 2 * i, n - i, r + i);
+
+}
+
+
+
+/**
+ * Population count of each 128-bit value (AVX-512 VPOPCNTQ)
+ * @param v array of 2n words
+ * @param n number of the 128-bit values
+ * @param r array of n results
+ */
+__attribute__ ((target ("avx512f,avx512bw,avx512vpopcntdq")))
+inline void popcntsAVX512POPCNT (const uint64_t *v, size_t n, uint32_t *r)
+{
+
+    size_t                  i     = 0;
+
+    // four values at a time
+    for (; i + 4 <= n; i += 4) {
+        __m512i c = _mm512_popcnt_epi64(_mm512_loadu_si512(v + 2 * i));
+        c         = _mm512_add_epi64(c, _mm512_shuffle_epi32(c, _MM_PERM_BADC));
+        c         = _mm512_maskz_compress_epi64(0x55, c);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(r + i),
+                         _mm256_castsi256_si128(_mm512_cvtepi64_epi32(c)));
+    }
+
+    popcntsScalar(v + 2 * i, n - i, r + i);
+
+}
+
+
+
+/**
+ * LSB of each 128-bit value (scalar)
+ * @param v array of 2n words
+ * @param n number of the 128-bit values
+ * @param r array of n results (NoBit if no bit is set)
+ * @param high index of bit 0 of the upper word (63 for Bitboard)
+ */
+inline void lsbsScalar (const uint64_t *v, size_t n, uint32_t *r,
+                        uint32_t high = 64)
+{
+
+    for (size_t i = 0; i < n; ++i) {
+        r[i] = v[2 * i    ] != 0 ? tzcnt(v[2 * i])              :
+               v[2 * i + 1] != 0 ? tzcnt(v[2 * i + 1]) + high   :
+                                   NoBit;
+    }
+
+}
+
+
+
+/**
+ * LSB of each 128-bit value (AVX-512 CD)
+ * The lowest bit is isolated by x & -x and counted by VPLZCNTQ, and the
+ * lower of the two words is taken with the empty words kept out.
+ * @param v array of 2n words
+ * @param n number of the 128-bit values
+ * @param r array of n results (NoBit if no bit is set)
+ * @param high index of bit 0 of the upper word (63 for Bitboard)
+ */
+__attribute__ ((target ("avx512f,avx512bw,avx512cd")))
+inline void lsbsAVX512 (const uint64_t *v, size_t n, uint32_t *r,
+                        uint32_t high = 64)
+{
+
+    const long long         h     = 63 + static_cast<long long>(high);
+    const __m512i           base  = _mm512_setr_epi64(63, h, 63, h,
+                                                      63, h, 63, h);
+    const __m512i           none  = _mm512_set1_epi64(NoBit);
+
+    size_t                  i     = 0;
+
+    // four values at a time
+    for (; i + 4 <= n; i += 4) {
+        __m512i x = _mm512_loadu_si512(v + 2 * i);
+        __m512i b = _mm512_and_si512(x, _mm512_sub_epi64(
+                                            _mm512_setzero_si512(), x));
+        __m512i t = _mm512_sub_epi64(base, _mm512_lzcnt_epi64(b));
+        t         = _mm512_mask_mov_epi64(none,
+                                          _mm512_test_epi64_mask(x, x), t);
+        t         = _mm512_min_epu64(t, _mm512_shuffle_epi32(t, _MM_PERM_BADC));
+        t         = _mm512_maskz_compress_epi64(0x55, t);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(r + i),
+                         _mm256_castsi256_si128(_mm512_cvtepi64_epi32(t)));
+    }
+
+    lsbsScalar(v + 2 * i, n - i, r + i, high);
+
+}
+
+
+
+/**
+ * AND (Conj = true) or OR (Conj = false) reduction of the 128-bit values
+ * (scalar)
+ * @param v array of 2n words
+ * @param n number of the 128-bit values
+ * @param r two words of the result
+ */
+template <bool Conj>
+inline void reduceScalar (const uint64_t *v, size_t n, uint64_t *r)
+{
+
+    uint64_t                r0 = Conj ? ~0ULL : 0ULL;
+    uint64_t                r1 = Conj ? ~0ULL : 0ULL;
+
+    for (size_t i = 0; i < n; ++i) {
+        r0 = Conj ? (r0 & v[2 * i    ]) : (r0 | v[2 * i    ]);
+        r1 = Conj ? (r1 & v[2 * i + 1]) : (r1 | v[2 * i + 1]);
+    }
+
+    r[0] = r0;
+    r[1] = r1;
+
+}
+
+
+
+/**
+ * AND or OR reduction of the 128-bit values (AVX2)
+ * @param v array of 2n words
+ * @param n number of the 128-bit values
+ * @param r two words of the result
+ */
+template <bool Conj>
+__attribute__ ((target ("avx2")))
+inline void reduceAVX2 (const uint64_t *v, size_t n, uint64_t *r)
+{
+
+    __m256i                 a  = Conj ? _mm256_set1_epi64x(-1)
+                                      : _mm256_setzero_si256();
+    size_t                  i  = 0;
+
+    // two values at a time
+    for (; i + 2 <= n; i += 2) {
+        __m256i x = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i *>(v + 2 * i));
+        a         = Conj ? _mm256_and_si256(a, x) : _mm256_or_si256(a, x);
+    }
+
+    // fold the two halves
+    __m128i                 h  = _mm256_extracti128_si256(a, 1);
+    __m128i                 l  = _mm256_castsi256_si128(a);
+    __m128i                 f  = Conj ? _mm_and_si128(h, l) : _mm_or_si128(h, l);
+
+    uint64_t                t[2];
+    reduceScalar<Conj>(v + 2 * i, n - i, t);
+    r[0] = Conj ? (t[0] & static_cast<uint64_t>(_mm_extract_epi64(f, 0)))
+                : (t[0] | static_cast<uint64_t>(_mm_extract_epi64(f, 0)));
+    r[1] = Conj ? (t[1] & static_cast<uint64_t>(_mm_extract_epi64(f, 1)))
+                : (t[1] | static_cast<uint64_t>(_mm_extract_epi64(f, 1)));
+
+}
+
+
+
+/**
+ * AND or OR reduction of the 128-bit values (AVX-512)
+ * @param v array of 2n words
+ * @param n number of the 128-bit values
+ * @param r two words of the result
+ */
+template <bool Conj>
+__attribute__ ((target ("avx512f,avx512bw")))
+inline void reduceAVX512 (const uint64_t *v, size_t n, uint64_t *r)
+{
+
+    __m512i                 a  = Conj ? _mm512_set1_epi64(-1)
+                                      : _mm512_setzero_si512();
+    size_t                  i  = 0;
+
+    // four values at a time
+    for (; i + 4 <= n; i += 4) {
+        __m512i x = _mm512_loadu_si512(v + 2 * i);
+        a         = Conj ? _mm512_and_si512(a, x) : _mm512_or_si512(a, x);
+    }
+
+    // fold the four quarters
+    __m256i                 h  = _mm512_extracti64x4_epi64(a, 1);
+    __m256i                 l  = _mm512_castsi512_si256(a);
+    __m256i                 g  = Conj ? _mm256_and_si256(h, l)
+                                      : _mm256_or_si256 (h, l);
+    __m128i                 u  = _mm256_extracti128_si256(g, 1);
+    __m128i                 d  = _mm256_castsi256_si128(g);
+    __m128i                 f  = Conj ? _mm_and_si128(u, d) : _mm_or_si128(u, d);
+
+    uint64_t                t[2];
+    reduceScalar<Conj>(v + 2 * i, n - i, t);
+    r[0] = Conj ? (t[0] & static_cast<uint64_t>(_mm_extract_epi64(f, 0)))
+                : (t[0] | static_cast<uint64_t>(_mm_extract_epi64(f, 0)));
+    r[1] = Conj ? (t[1] & static_cast<uint64_t>(_mm_extract_epi64(f, 1)))
+                : (t[1] | static_cast<uint64_t>(_mm_extract_epi64(f, 1)));
+
+}
+
+#pragma GCC diagnostic pop
+
+
+
+/**
+ * Population count of each 128-bit value
+ * The nibble table of AVX2 is slower than POPCNT on two words, so the
+ * processors without AVX-512 take the scalar loop.
+ * @param v array of 2n words
+ * @param n number of the 128-bit values
+ * @param r array of n results
+ */
+inline void popcnts (const uint64_t *v, size_t n, uint32_t *r)
+{
+
+    switch (simd()) {
+    case AVX512POPCNT:
+        popcntsAVX512POPCNT(v, n, r);
+        break;
+    case AVX512:
+        popcntsAVX512(v, n, r);
+        break;
+    case AVX2:
+    case Scalar:
+    default:
+        popcntsScalar(v, n, r);
+        break;
+    }
+
+}
+
+
+
+/**
+ * LSB of each 128-bit value
+ * AVX2 has no 64-bit count of the zeros, so only AVX-512 CD is taken.
+ * @param v array of 2n words
+ * @param n number of the 128-bit values
+ * @param r array of n results (NoBit if no bit is set)
+ * @param high index of bit 0 of the upper word (63 for Bitboard)
+ */
+inline void lsbs (const uint64_t *v, size_t n, uint32_t *r,
+                  uint32_t high = 64)
+{
+
+    static const bool       cd = [] () {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512cd") != 0;
+    } ();
+
+    if (simd() >= AVX512 && cd) {
+        lsbsAVX512(v, n, r, high);
+    } else {
+        lsbsScalar(v, n, r, high);
+    }
+
+}
+
+
+
+/**
+ * AND reduction of the 128-bit values
+ * @param v array of 2n words
+ * @param n number of the 128-bit values
+ * @param r two words of the result (all bits set if n is zero)
+ */
+inline void andReduce (const uint64_t *v, size_t n, uint64_t *r)
+{
+
+    switch (simd()) {
+    case AVX512POPCNT:
+    case AVX512:
+        reduceAVX512<true>(v, n, r);
+        break;
+    case AVX2:
+        reduceAVX2<true>(v, n, r);
+        break;
+    case Scalar:
+    default:
+        reduceScalar<true>(v, n, r);
+        break;
+    }
+
+}
+
+
+
+/**
+ * OR reduction of the 128-bit values
+ * @param v array of 2n words
+ * @param n number of the 128-bit values
+ * @param r two words of the result
+ */
+inline void orReduce (const uint64_t *v, size_t n, uint64_t *r)
+{
+
+    switch (simd()) {
+    case AVX512POPCNT:
+    case AVX512:
+        reduceAVX512<false>(v, n, r);
+        break;
+    case AVX2:
+        reduceAVX2<false>(v, n, r);
+        break;
+    case Scalar:
+    default:
+        reduceScalar<false>(v, n, r);
+        break;
+    }
+
+}
+
+/* ------------------------------------------------------------------------- */
+
 // end namespace 'foundation::Bitope'
 } }
 
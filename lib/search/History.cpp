@@ -0,0 +1,185 @@
+/**
+ *****************************************************************************
+
+ @file       History.cpp
+
+ @brief      Move ordering heuristics implementation
+
+ @author     Hiroki Takada (http://wwww.tsoftware.jp/)
+
+ @date       2026-10-18
+
+ @version    $Id:$
+
+
+  Copyright 2014, 2015, 2016, 2017 Hiroki Takada
+
+  This file is part of libshogi.
+
+  libshogi is free software: you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  libshogi is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with libshogi. If not, see <http://www.gnu.org/licenses/>.
+
+
+  ----------------------------------------------------------------------------
+  RELEASE NOTE :
+
+   DATE          REV    REMARK
+  ============= ====== =======================================================
+  18th Oct 2026  0.1   Initial release
+
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <History.h>
+
+// begin namespace 'game'
+namespace game {
+
+/* ---------------------------- implementations ---------------------------- */
+
+/**
+ * Constructor
+ *
+ */
+History::History ()
+{
+
+    clear();
+
+}
+
+
+
+/**
+ * Clear all the tables
+ *
+ */
+void History::clear (void)
+{
+
+    memset(_killer , 0, sizeof(_killer ));
+    memset(_history, 0, sizeof(_history));
+    memset(_counter, 0, sizeof(_counter));
+
+}
+
+
+
+/**
+ * Write the ordering scores in the value field of the moves
+ * The capturing moves are ordered by the value of the victim, and then by
+ * the value of the piece capturing it (MVV/LVA).
+ * @param p position
+ * @param m moves generated in the position
+ * @param ply distance from the root
+ * @param prev move leading to the position
+ */
+void History::score (const Position &p, Moves &m, int ply,
+                     Move::Move prev) const
+{
+
+    Color::Color            c  = p.turn();
+    Move::Move              k0 = _killer[ply][0];
+    Move::Move              k1 = _killer[ply][1];
+    Move::Move              cm = counter(prev);
+
+    for (auto &move : m) {
+
+        Move::Move          mv = static_cast<Move::Move>(
+                                                move & Move::MoveMask);
+        int                 v;
+
+        if (! quiet(p, mv)) {
+            v = Capture
+              + std::abs(Evaluation::Value[p.square(Move::to  (mv))]) * 8
+              - std::abs(Evaluation::Value[p.square(Move::from(mv))]) / 16;
+        } else
+        if (mv == k0) {
+            v = Killer;
+        } else
+        if (mv == k1) {
+            v = Killer - 1;
+        } else
+        if (mv == cm) {
+            v = Counter;
+        } else {
+            v = _history[c][_from(mv)][Move::to(mv)];
+        }
+
+        move = Move::setValue(v, mv);
+
+    }
+
+}
+
+
+
+/**
+ * Learn the quiet move causing a cutoff
+ * The move becomes the first killer move of the ply and the countermove
+ * of the previous move. Its history gets the bonus of the depth squared,
+ * and the quiet moves searched before it get the same malus.
+ * @param c color moving
+ * @param m move causing the cutoff
+ * @param tried quiet moves searched before the move
+ * @param n number of the moves in tried
+ * @param ply distance from the root
+ * @param depth remaining depth
+ * @param prev move leading to the position
+ */
+void History::good (Color::Color c, Move::Move m, const Move::Move *tried,
+                    int n, int ply, int depth, Move::Move prev)
+{
+
+    m = static_cast<Move::Move>(m & Move::MoveMask);
+
+    if (_killer[ply][0] != m) {
+        _killer[ply][1] = _killer[ply][0];
+        _killer[ply][0] = m;
+    }
+
+    if (! Move::isNull(prev)) {
+        _counter[prev & Move::MoveMask] = static_cast<uint16_t>(m);
+    }
+
+    int                     bonus = std::min(depth * depth, Limit / 8);
+    _gravity(_history[c][_from(m)][Move::to(m)], bonus);
+    for (int i = 0; i < n; ++i) {
+        _gravity(_history[c][_from(tried[i])][Move::to(tried[i])], -bonus);
+    }
+
+}
+
+
+
+/**
+ * Add the bonus to the score with the gravity
+ * The bonus is scaled down by the score already given, so the score
+ * never exceeds the limit.
+ * @param h score
+ * @param bonus bonus (negative for malus)
+ */
+void History::_gravity (int16_t &h, int bonus)
+{
+
+    h = static_cast<int16_t>(h + bonus - h * std::abs(bonus) / Limit);
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+// end namespace 'game'
+}
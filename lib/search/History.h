@@ -0,0 +1,242 @@
+/**
+ *****************************************************************************
+
+ @file       History.h
+
+ @brief      Move ordering heuristics definitions
+
+ @author     Hiroki Takada (http://wwww.tsoftware.jp/)
+
+ @date       2026-10-18
+
+ @version    $Id:$
+
+
+  Copyright 2014, 2015, 2016, 2017 Hiroki Takada
+
+  This file is part of libshogi.
+
+  libshogi is free software: you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  libshogi is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with libshogi. If not, see <http://www.gnu.org/licenses/>.
+
+
+  ----------------------------------------------------------------------------
+  RELEASE NOTE :
+
+   DATE          REV    REMARK
+  ============= ====== =======================================================
+  18th Oct 2026  0.1   Initial release
+
+ *****************************************************************************/
+
+#ifndef _GAME_HISTORY_H
+#define _GAME_HISTORY_H
+
+#include <Common.h>
+
+#include <Array.h>
+#include <Position.h>
+
+// begin namespace 'game'
+namespace game {
+
+/* ---------------------------- History class ------------------------------ */
+
+/**
+ *  Move ordering heuristics of a search thread
+ *
+ *  The tables learn the quiet moves refuting the positions in the search:
+ *  the killer moves of each ply, the butterfly history indexed by the
+ *  color, the square moved from (the piece for the dropping moves) and
+ *  the square moved to, and the countermove answering the previous move.
+ *  score() writes the ordering scores of the moves in the value field of
+ *  Move::Move, so the moves are sorted in place by the value;
+ *
+ *    Capture + MVV/LVA     capturing moves, the most valuable victim first
+ *    Killer, Killer - 1    killer moves of the ply
+ *    Counter               countermove of the previous move
+ *    -Limit .. Limit       history of the other quiet moves
+ *
+ *  The history is aged by the gravity; a bonus is scaled down as the
+ *  score approaches the limit, which keeps the score in 16 bits and lets
+ *  the recent results outweigh the old ones.
+ *
+ *  The tables are not shared, each thread owns one.
+ *
+ */
+class History
+{
+
+public:
+
+    /// Number of plies having the killer moves
+    static constexpr int    Plies       = 64;
+
+    /// Number of the killer moves per ply
+    static constexpr int    Killers     = 2;
+
+    /// Limit of the history scores
+    static constexpr int    Limit       = 8192;
+
+    /// Score of the countermove
+    static constexpr int    Counter     = 14000;
+
+    /// Score of the first killer move
+    static constexpr int    Killer      = 15000;
+
+    /// Base score of the capturing moves
+    static constexpr int    Capture     = 16384;
+
+    /// Moves in a position
+    using Moves             = foundation::Array<Move::Move, Move::Max>;
+
+
+
+    /// Constructor
+    History ();
+
+    /// Clear all the tables
+    void                    clear      (void);
+
+    /// Write the ordering scores in the value field of the moves
+    void                    score      (const Position &, Moves &,
+                                        int, Move::Move)            const;
+
+    /// Learn the quiet move causing a cutoff
+    void                    good       (Color::Color, Move::Move,
+                                        const Move::Move *, int,
+                                        int, int, Move::Move);
+
+    /// Killer move of the ply
+    Move::Move              killer     (int, int)                   const;
+
+    /// Countermove of the previous move
+    Move::Move              counter    (Move::Move)                 const;
+
+    /// History score of the move
+    int                     history    (Color::Color, Move::Move)   const;
+
+    /// Check if the move is quiet (not capturing)
+    static bool             quiet      (const Position &, Move::Move);
+
+private:
+
+    /// Rows of the history, the squares and the pieces dropped
+    static constexpr int    Froms       = Square::Squares + Piece::Kind;
+
+    /// Row of the history for the move
+    static int              _from      (Move::Move);
+
+    /// Add the bonus to the score with the gravity
+    static void             _gravity   (int16_t &, int);
+
+    /// Killer moves
+    Move::Move              _killer[Plies][Killers];
+
+    /// Butterfly history
+    int16_t                 _history[Color::Colors][Froms][Square::Squares];
+
+    /// Countermoves
+    uint16_t                _counter[Move::MoveMask + 1];
+
+};
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ---------------------------- implementations ---------------------------- */
+
+/**
+ * Row of the history for the move
+ * The dropping moves have the piece in the field of the square moved
+ * from, which is mapped beyond the squares.
+ * @param m move
+ * @return row
+ */
+inline int History::_from (Move::Move m)
+{
+
+    if (m & Move::Drop) {
+        return Square::Squares + (Move::from(m) & Piece::Mask);
+    }
+
+    return Move::from(m);
+
+}
+
+
+
+/**
+ * Killer move of the ply
+ * @param ply distance from the root
+ * @param i slot of the killer moves
+ * @return killer move (Move::None if none)
+ */
+inline Move::Move History::killer (int ply, int i) const
+{
+
+    return _killer[ply][i];
+
+}
+
+
+
+/**
+ * Countermove of the previous move
+ * @param m previous move
+ * @return countermove (Move::None if none)
+ */
+inline Move::Move History::counter (Move::Move m) const
+{
+
+    return static_cast<Move::Move>(_counter[m & Move::MoveMask]);
+
+}
+
+
+
+/**
+ * History score of the move
+ * @param c color moving
+ * @param m move
+ * @return score from -Limit to Limit
+ */
+inline int History::history (Color::Color c, Move::Move m) const
+{
+
+    return _history[c][_from(m)][Move::to(m)];
+
+}
+
+
+
+/**
+ * Check if the move is quiet (not capturing)
+ * @param p position before the move
+ * @param m move
+ * @return true if quiet
+ */
+inline bool History::quiet (const Position &p, Move::Move m)
+{
+
+    return (m & Move::Drop) || p.square(Move::to(m)) == Piece::EMP;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+// end namespace 'game'
+}
+
+#endif
@@ -0,0 +1,237 @@
+/**
+ *****************************************************************************
+
+ @file       Parameters.cpp
+
+ @brief      Search parameters implementation
+
+ @author     Hiroki Takada (http://wwww.tsoftware.jp/)
+
+ @date       2026-10-18
+
+ @version    $Id:$
+
+
+  Copyright 2014, 2015, 2016, 2017 Hiroki Takada
+
+  This file is part of libshogi.
+
+  libshogi is free software: you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  libshogi is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with libshogi. If not, see <http://www.gnu.org/licenses/>.
+
+
+  ----------------------------------------------------------------------------
+  RELEASE NOTE :
+
+   DATE          REV    REMARK
+  ============= ====== =======================================================
+  18th Oct 2026  0.1   Initial release
+
+ *****************************************************************************/
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include <Parameters.h>
+
+// begin namespace 'game'
+namespace game {
+
+/* ---------------------------- static members ----------------------------- */
+
+/// Default values and the ranges
+const Parameters::Entry Parameters::Default[Size] = {
+    { "LMRDepth"         ,   3,    1,   64 },
+    { "LMRMoves"         ,   3,    1,  600 },
+    { "LMRBase"          ,  25,    0,  400 },
+    { "LMRScale"         ,  40,    0,  400 },
+    { "FutilityDepth"    ,   3,    0,   64 },
+    { "FutilityMargin"   , 150,    0, 9999 },
+    { "RazorDepth"       ,   2,    0,   64 },
+    { "RazorMargin"      , 300,    0, 9999 },
+    { "MultiCutDepth"    ,   8,    1,   65 },
+    { "MultiCutReduction",   4,    1,   64 },
+    { "MultiCutMoves"    ,   6,    1,  600 },
+    { "MultiCutCuts"     ,   3,    1,  600 }
+};
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ---------------------------- implementations ---------------------------- */
+
+/**
+ * Constructor sets the default values
+ *
+ */
+Parameters::Parameters ()
+{
+
+    reset();
+
+}
+
+
+
+/**
+ * Set the parameter (clipped in the range)
+ * @param i index
+ * @param v value
+ */
+void Parameters::set (Index i, int v)
+{
+
+    _entry[i].value = std::max(_entry[i].min, std::min(v, _entry[i].max));
+
+}
+
+
+
+/**
+ * Set the parameter of the name
+ * @param name name of the parameter
+ * @param v value
+ * @return false if the name is unknown
+ */
+bool Parameters::set (const std::string &name, int v)
+{
+
+    Index                   i = find(name);
+    if (i == Size) {
+        return false;
+    }
+    set(i, v);
+
+    return true;
+
+}
+
+
+
+/**
+ * Index of the parameter of the name
+ * @param name name of the parameter
+ * @return index (Size if unknown)
+ */
+Parameters::Index Parameters::find (const std::string &name)
+{
+
+    int                     i = 0;
+    while (i < Size && name != Default[i].name) {
+        ++i;
+    }
+
+    return static_cast<Index>(i);
+
+}
+
+
+
+/**
+ * Restore the default values
+ *
+ */
+void Parameters::reset (void)
+{
+
+    for (int i = 0; i < Size; ++i) {
+        _entry[i] = Default[i];
+    }
+
+}
+
+
+
+/**
+ * Read the parameters from the file
+ * The parameters not in the file keep their values. The file is read
+ * into a copy, so a malformed line leaves all the parameters as they
+ * were.
+ * @param filename path to the file
+ */
+void Parameters::load (const std::string &filename)
+{
+
+    std::ifstream           ifs(filename.c_str());
+    if (! ifs) {
+        throw ParametersIOException();
+    }
+
+    Parameters              t(*this);
+    std::string             l;
+    while (std::getline(ifs, l)) {
+        auto                ptr = l.find('#');
+        if (ptr != std::string::npos) {
+            l.erase(ptr);
+        }
+        std::istringstream  is(l);
+        std::string         name;
+        int                 v;
+        if (! (is >> name)) {
+            continue;
+        }
+        if (! (is >> v) || ! t.set(name, v)) {
+            throw ParametersException();
+        }
+    }
+
+    *this = t;
+
+}
+
+
+
+/**
+ * Write the parameters to the file
+ * @param filename path to the file
+ */
+void Parameters::save (const std::string &filename) const
+{
+
+    std::ofstream           ofs(filename.c_str());
+    if (! ofs) {
+        throw ParametersIOException();
+    }
+
+    ofs << *this;
+    if (! ofs) {
+        throw ParametersIOException();
+    }
+
+}
+
+
+
+/**
+ * Output the parameters
+ * @param os output stream
+ * @param p parameters
+ * @return output stream
+ */
+std::ostream & operator<< (std::ostream &os, const Parameters &p)
+{
+
+    for (auto &e : p._entry) {
+        os << e.name << " " << e.value << std::endl;
+    }
+
+    return os;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+// end namespace 'game'
+}
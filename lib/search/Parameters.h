@@ -0,0 +1,226 @@
+/**
+ *****************************************************************************
+
+ @file       Parameters.h
+
+ @brief      Search parameters definitions
+
+ @author     Hiroki Takada (http://wwww.tsoftware.jp/)
+
+ @date       2026-10-18
+
+ @version    $Id:$
+
+
+  Copyright 2014, 2015, 2016, 2017 Hiroki Takada
+
+  This file is part of libshogi.
+
+  libshogi is free software: you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  libshogi is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with libshogi. If not, see <http://www.gnu.org/licenses/>.
+
+
+  ----------------------------------------------------------------------------
+  RELEASE NOTE :
+
+   DATE          REV    REMARK
+  ============= ====== =======================================================
+  18th Oct 2026  0.1   Initial release
+
+ *****************************************************************************/
+
+#ifndef _GAME_PARAMETERS_H
+#define _GAME_PARAMETERS_H
+
+#include <iostream>
+#include <string>
+
+#include <Common.h>
+
+// begin namespace 'game'
+namespace game {
+
+/* ------------------------- parameters exceptions ------------------------- */
+class ParametersException {};
+class ParametersIOException : public ParametersException {};
+/* ------------------------------------------------------------------------- */
+
+
+
+/* -------------------------- Parameters class ----------------------------- */
+
+/**
+ *  Table of the search parameters tunable at runtime
+ *
+ *  The parameters of the pruning and the reductions are kept in a table
+ *  of the named integers, each of which has its range. They are read by
+ *  the index in the search, and written by the name between the searches,
+ *  so a tuner playing games by itself can change them without building
+ *  the engine again. load() and save() read and write the table in the
+ *  text of the lines "name value", where '#' starts a comment.
+ *
+ *  The margins are in the units of Evaluation::Value (FU is 100), and
+ *  the late move reduction of the move i at the depth d is
+ *
+ *    (LMRBase + LMRScale * log(d) * log(i)) / 100 plies.
+ *
+ *  FutilityDepth or RazorDepth of 0 and MultiCutDepth beyond the plies
+ *  searched turn the technique off.
+ *
+ */
+class Parameters
+{
+
+public:
+
+    /// Index of the parameters
+    enum Index : int {
+
+        /// Minimum depth to reduce the late moves
+        LMRDepth            = 0,
+
+        /// Number of the moves searched in full before reducing
+        LMRMoves,
+
+        /// Constant term of the reduction (1/100 plies)
+        LMRBase,
+
+        /// Scale of the reduction by the depth and the moves (1/100)
+        LMRScale,
+
+        /// Maximum depth of the futility pruning
+        FutilityDepth,
+
+        /// Futility margin per ply
+        FutilityMargin,
+
+        /// Maximum depth of the razoring
+        RazorDepth,
+
+        /// Razoring margin per ply
+        RazorMargin,
+
+        /// Minimum depth of the multi-cut
+        MultiCutDepth,
+
+        /// Depth reduced by the multi-cut search
+        MultiCutReduction,
+
+        /// Number of the moves tried by the multi-cut
+        MultiCutMoves,
+
+        /// Number of the cutoffs for the multi-cut to prune
+        MultiCutCuts,
+
+        /// Number of the parameters
+        Size
+
+    };
+
+    /// Parameter
+    struct Entry {
+
+        /// Name
+        const char *        name;
+
+        /// Value
+        int                 value;
+
+        /// Minimum value
+        int                 min;
+
+        /// Maximum value
+        int                 max;
+
+    };
+
+
+
+    /// Constructor sets the default values
+    Parameters ();
+
+    /// Value of the parameter
+    int                     operator[] (Index)                      const;
+
+    /// Set the parameter (clipped in the range)
+    void                    set        (Index, int);
+
+    /// Set the parameter of the name
+    bool                    set        (const std::string &, int);
+
+    /// Parameter of the index
+    const Entry &           entry      (Index)                      const;
+
+    /// Index of the parameter of the name (Size if unknown)
+    static Index            find       (const std::string &);
+
+    /// Restore the default values
+    void                    reset      (void);
+
+    /// Read the parameters from the file
+    void                    load       (const std::string &);
+
+    /// Write the parameters to the file
+    void                    save       (const std::string &)        const;
+
+    /// Output the parameters
+    friend std::ostream &   operator<< (std::ostream &, const Parameters &);
+
+private:
+
+    /// Default values and the ranges
+    static const Entry      Default[Size];
+
+    /// Parameters
+    Entry                   _entry[Size];
+
+};
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ---------------------------- implementations ---------------------------- */
+
+/**
+ * Value of the parameter
+ * @param i index
+ * @return value
+ */
+inline int Parameters::operator[] (Index i) const
+{
+
+    return _entry[i].value;
+
+}
+
+
+
+/**
+ * Parameter of the index
+ * @param i index
+ * @return parameter
+ */
+inline const Parameters::Entry & Parameters::entry (Index i) const
+{
+
+    return _entry[i];
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+// end namespace 'game'
+}
+
+#endif
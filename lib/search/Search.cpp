@@ -0,0 +1,1495 @@
+/**
+ *****************************************************************************
+
+ @file       Search.cpp
+
+ @brief      Parallel alpha-beta search implementation
+
+ @author     Hiroki Takada (http://wwww.tsoftware.jp/)
+
+ @date       2026-10-18
+
+ @version    $Id:$
+
+
+  Copyright 2014, 2015, 2016, 2017 Hiroki Takada
+
+  This file is part of libshogi.
+
+  libshogi is free software: you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  libshogi is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with libshogi. If not, see <http://www.gnu.org/licenses/>.
+
+
+  ----------------------------------------------------------------------------
+  RELEASE NOTE :
+
+   DATE          REV    REMARK
+  ============= ====== =======================================================
+  18th Oct 2026  0.1   Initial release
+
+ *****************************************************************************/
+
+#include <sched.h>
+#include <cmath>
+
+#include <Search.h>
+
+// begin namespace 'game'
+namespace game {
+
+/* ------------------------------- parameters ------------------------------ */
+
+// Key XORed to the positions of white to move
+static const Zobrist::key   _side        = 0x9e3779b97f4a7c15ULL;
+
+// Depths skipped by the helpers; a helper skips the depth d when
+// ((d + phase) / size) is odd, so the helpers spread over the depths
+static const int            _skips       = 20;
+static const int            _skipSize [_skips] =
+                                { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                  3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+static const int            _skipPhase[_skips] =
+                                { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3,
+                                  4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ---------------------------- implementations ---------------------------- */
+
+/**
+ * Constructor
+ * The helper threads are created here and sleep until go() is called.
+ * @param t transposition table shared by the threads
+ * @param n number of threads including the calling thread
+ * @param s scheduler of the threads
+ */
+Search::Search (TranspositionTable &t, int n, Scheduler s) :
+    _table(t), _threads(0), _scheduler(s), _idlers(0), _position(nullptr),
+    _limit(0), _pvs(1), _nlines(0), _stop(0), _next(0), _task(0), _running(0), _quit(false),
+    _expected(Move::None), _pondering(false)
+{
+
+    if (n < 1) {
+        n = 1;
+    }
+    if (n > Threads) {
+        n = Threads;
+    }
+
+    pthread_mutex_init(&_lock, nullptr);
+    pthread_cond_init (&_wake, nullptr);
+    pthread_cond_init (&_idle, nullptr);
+
+    for (int i = 0; i < n; ++i) {
+        Worker *            w = new Worker;
+        w->search = this;
+        w->id     = i;
+        w->nodes  = 0;
+        w->best   = Move::None;
+        w->value  = 0;
+        w->depth  = 0;
+        w->split  = nullptr;
+        w->tail   = 0;
+        _worker[i] = w;
+        ++_threads;
+        if (i == 0) {
+            continue;
+        }
+        if (pthread_create(&w->thread, nullptr, _helper, w) != 0) {
+            _GAME_SEARCH_DEBUG_FUNCTION_RESULT("pthread_create()");
+            --_threads;
+            delete w;
+            break;
+        }
+    }
+
+}
+
+
+
+/**
+ * Destructor
+ * A subclass overriding evaluate() or report() must stop() and wait() in
+ * its own destructor, as its part is gone when this one is called.
+ */
+Search::~Search ()
+{
+
+    stop();
+    wait();
+
+    pthread_mutex_lock(&_lock);
+    _quit = true;
+    pthread_cond_broadcast(&_wake);
+    pthread_mutex_unlock(&_lock);
+
+    for (int i = 1; i < _threads; ++i) {
+        pthread_join(_worker[i]->thread, nullptr);
+    }
+    for (int i = 0; i < _threads; ++i) {
+        delete _worker[i];
+    }
+
+    pthread_cond_destroy (&_idle);
+    pthread_cond_destroy (&_wake);
+    pthread_mutex_destroy(&_lock);
+
+}
+
+
+
+/**
+ * Search the position to the given depth and return the best move
+ * The helpers are woken up and the calling thread searches as the main
+ * thread. The search ends when the main thread completes the depth or
+ * stop() is called, and the helpers are stopped before returning. Each
+ * call starts a new generation of the transposition table, and stops
+ * the search pondering if any.
+ * @param p position to search
+ * @param d depth to search
+ * @return best move (Move::None if no legal move)
+ */
+Move::Move Search::go (const Position &p, int d)
+{
+
+    // the search in the background is of no use any more
+    if (_pondering) {
+        stop();
+        wait();
+    }
+
+    _start(p, d);
+    _iterate(*_worker[0]);
+
+    return _finish();
+
+}
+
+
+
+/**
+ * Search the position after the expected move in the background
+ * The main thread of the search runs on a thread of its own, and this
+ * returns at once. The search goes on until the opponent plays; the move
+ * played is told by ponderhit(), and the result is taken by wait().
+ * @param p position before the expected move
+ * @param m expected move
+ * @param d depth to search
+ * @return false if the search could not be started
+ */
+bool Search::ponder (const Position &p, Move::Move m, int d)
+{
+
+    // the search in the background is of no use any more
+    if (_pondering) {
+        stop();
+        wait();
+    }
+
+    _pondered = p;
+    _pondered.move(m);
+    _expected = static_cast<Move::Move>(m & Move::MoveMask);
+
+    _start(_pondered, d);
+    if (pthread_create(&_ponderer, nullptr, _ponder, this) != 0) {
+        _GAME_SEARCH_DEBUG_FUNCTION_RESULT("pthread_create()");
+        _finish();
+        return false;
+    }
+    _pondering = true;
+
+    return true;
+
+}
+
+
+
+/**
+ * Tell the move played by the opponent while pondering
+ * The search goes on when the move was expected (ponder hit), and the
+ * time spent so far is not lost. Otherwise the search is stopped, and
+ * only the transposition table is left for the next search.
+ * @param m move played
+ * @return true if the move was expected
+ */
+bool Search::ponderhit (Move::Move m)
+{
+
+    if (! _pondering) {
+        return false;
+    }
+    if ((m & Move::MoveMask) == _expected) {
+        return true;
+    }
+
+    stop();
+    wait();
+
+    return false;
+
+}
+
+
+
+/**
+ * Wait for the search in the background to end
+ * This returns at once when not pondering.
+ * @return best move of the search
+ */
+Move::Move Search::wait (void)
+{
+
+    if (_pondering) {
+        pthread_join(_ponderer, nullptr);
+        _pondering = false;
+        _finish();
+    }
+
+    return best();
+
+}
+
+
+
+/**
+ * Check if the search is running in the background
+ * @return true if pondering
+ */
+bool Search::pondering (void) const
+{
+
+    return _pondering;
+
+}
+
+
+
+/**
+ * Expected move being pondered
+ * @return expected move (Move::None if not pondering)
+ */
+Move::Move Search::expected (void) const
+{
+
+    return _pondering ? _expected : Move::None;
+
+}
+
+
+
+/**
+ * Best move of the last iteration completed
+ * @return best move
+ */
+Move::Move Search::best (void) const
+{
+
+    return __atomic_load_n(&_worker[0]->best, __ATOMIC_RELAXED);
+
+}
+
+
+
+/**
+ * Value of the best move
+ * @return value from the side to move
+ */
+Evaluation::Eval Search::value (void) const
+{
+
+    return _worker[0]->value;
+
+}
+
+
+
+/**
+ * Depth of the last iteration completed
+ * @return depth
+ */
+int Search::depth (void) const
+{
+
+    return _worker[0]->depth;
+
+}
+
+
+
+/**
+ * Principal variation of the last iteration completed
+ * This is to be called after go() returns.
+ * @return moves from the root
+ */
+Search::Moves Search::pv (void) const
+{
+
+    return _worker[0]->line;
+
+}
+
+
+
+/**
+ * Number of nodes searched by all the threads
+ * This can be called while searching.
+ * @return number of nodes
+ */
+uint64_t Search::nodes (void) const
+{
+
+    uint64_t                n = 0;
+
+    for (int i = 0; i < _threads; ++i) {
+        n += __atomic_load_n(&_worker[i]->nodes, __ATOMIC_RELAXED);
+    }
+
+    return n;
+
+}
+
+
+
+/**
+ * Set the number of the principal variations (MultiPV)
+ * The lines after the best one are searched by the main thread only. It
+ * is to be changed between the searches.
+ * @param n number of the lines (1 to MaxPV)
+ */
+void Search::multiPV (int n)
+{
+
+    _pvs = std::max(1, std::min(n, static_cast<int>(MaxPV)));
+
+}
+
+
+
+/**
+ * Number of the principal variations asked
+ * @return number of the lines
+ */
+int Search::multiPV (void) const
+{
+
+    return _pvs;
+
+}
+
+
+
+/**
+ * Number of the lines of the last iteration completed
+ * This is less than multiPV() when the root has fewer moves.
+ * @return number of the lines
+ */
+int Search::lines (void) const
+{
+
+    return _nlines;
+
+}
+
+
+
+/**
+ * Line of the rank given
+ * This is to be called after go() returns.
+ * @param i rank of the line (0 for the best)
+ * @return line of the last iteration completed in all the lines
+ */
+Search::Line Search::line (int i) const
+{
+
+    if (i < 0 || i >= _nlines) {
+        throw SearchException();
+    }
+
+    return _lines[i];
+
+}
+
+
+
+/**
+ * Number of threads
+ * @return number of threads including the main thread
+ */
+int Search::threads (void) const
+{
+
+    return _threads;
+
+}
+
+
+
+/**
+ * Scheduler of the threads
+ * @return scheduler
+ */
+Search::Scheduler Search::scheduler (void) const
+{
+
+    return _scheduler;
+
+}
+
+
+
+/**
+ * Parameters of the pruning
+ * They are read by the threads while searching, so they are to be
+ * changed between the searches.
+ * @return parameters
+ */
+Parameters & Search::parameters (void)
+{
+
+    return _params;
+
+}
+
+
+
+/**
+ * Parameters of the pruning
+ * @return parameters
+ */
+const Parameters & Search::parameters (void) const
+{
+
+    return _params;
+
+}
+
+
+
+/**
+ * Evaluate the position from the side to move
+ * Position::eval() is from black, and is negated for white.
+ * @param p position
+ * @return evaluation
+ */
+Evaluation::Eval Search::evaluate (Position &p)
+{
+
+    Evaluation::Eval        v = p.eval();
+
+    return p.turn() == Color::Black ? v : -v;
+
+}
+
+
+
+/**
+ * Report the line of the rank found by the main thread
+ * This is called on the main thread while searching, and does nothing
+ * here. A subclass may override it to show the lines as they are found.
+ * @param i rank of the line (0 for the best)
+ * @param l line found
+ */
+void Search::report (int, const Line &)
+{
+
+}
+
+
+
+/**
+ * Start the search
+ * The helpers are woken up. The flag stopping the search is cleared here,
+ * so stop() called after this is never lost.
+ * @param p position to search
+ * @param d depth to search
+ */
+void Search::_start (const Position &p, int d)
+{
+
+    _table.newSearch();
+    clock_gettime(CLOCK_MONOTONIC, &_begin);
+
+    // the reductions by the parameters given
+    for (int i = 0; i < MaxPly; ++i) {
+        for (int j = 0; j < MaxPly; ++j) {
+            double          r = _params[Parameters::LMRBase];
+            if (i > 0 && j > 0) {
+                r += _params[Parameters::LMRScale] * log(i) * log(j);
+            }
+            _reductions[i][j] = static_cast<int>(r / 100);
+        }
+    }
+
+    // the counters are cleared before the helpers wake up, as the main
+    // thread reads them while searching
+    for (int i = 0; i < _threads; ++i) {
+        __atomic_store_n(&_worker[i]->nodes, 0, __ATOMIC_RELAXED);
+    }
+
+    pthread_mutex_lock(&_lock);
+    _position = &p;
+    _limit    = std::min(d, MaxPly - QuiesPly - 1);
+    _running  = _threads - 1;
+    __atomic_store_n(&_stop, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_next, 0, __ATOMIC_RELAXED);
+    ++_task;
+    pthread_cond_broadcast(&_wake);
+    pthread_mutex_unlock(&_lock);
+
+}
+
+
+
+/**
+ * Finish the search
+ * The helpers are stopped and waited for.
+ * @return best move
+ */
+Move::Move Search::_finish (void)
+{
+
+    stop();
+    pthread_mutex_lock(&_lock);
+    while (_running > 0) {
+        pthread_cond_wait(&_idle, &_lock);
+    }
+    pthread_mutex_unlock(&_lock);
+
+    return best();
+
+}
+
+
+
+/**
+ * Main thread of the search pondering
+ * @param arg search
+ * @return nullptr
+ */
+void * Search::_ponder (void *arg)
+{
+
+    Search &                s = *static_cast<Search *>(arg);
+
+    s._iterate(*s._worker[0]);
+
+    return nullptr;
+
+}
+
+
+
+/**
+ * Helper thread
+ * The thread sleeps until the next task is given.
+ * @param arg thread
+ * @return nullptr
+ */
+void * Search::_helper (void *arg)
+{
+
+    Worker &                w    = *static_cast<Worker *>(arg);
+    Search &                s    = *w.search;
+    unsigned                task = 0;
+
+    while (1) {
+
+        pthread_mutex_lock(&s._lock);
+        while (! s._quit && s._task == task) {
+            pthread_cond_wait(&s._wake, &s._lock);
+        }
+        if (s._quit) {
+            pthread_mutex_unlock(&s._lock);
+            break;
+        }
+        task = s._task;
+        pthread_mutex_unlock(&s._lock);
+
+        if (s._scheduler == LazySMP) {
+            s._iterate(w);
+        } else {
+            s._thief(w);
+        }
+
+        pthread_mutex_lock(&s._lock);
+        if (--s._running == 0) {
+            pthread_cond_signal(&s._idle);
+        }
+        pthread_mutex_unlock(&s._lock);
+
+    }
+
+    return nullptr;
+
+}
+
+
+
+/**
+ * Callback of the moves prefetching the table
+ * @param p position after the move
+ * @param arg search
+ */
+void Search::_prefetch (const Position &p, void *arg)
+{
+
+    static_cast<Search *>(arg)->_table.prefetch(_key(p));
+
+}
+
+
+
+/**
+ * Iterative deepening
+ * The helpers skip some of the depths to run ahead of the main thread.
+ * The best move of the root is searched first in the next iteration.
+ * The main thread searches the other lines after the best one.
+ * @param w thread
+ */
+void Search::_iterate (Worker &w)
+{
+
+    w.position = *_position;
+    w.position.hook(_prefetch, this);
+    w.depth    = 0;
+    w.value    = 0;
+    w.split    = nullptr;
+    w.line.setsz(0);
+    if (w.id == 0) {
+        _nlines = 0;
+    }
+
+    // legal moves at the root
+    w.root.setsz(0);
+    w.position.genMove(w.root);
+    __atomic_store_n(&w.best, w.root.vsize() > 0 ? w.root[0] : Move::None,
+                     __ATOMIC_RELAXED);
+    if (w.root.vsize() == 0) {
+        w.value = -Evaluation::Infinity;
+        return;
+    }
+
+    for (int d = 1; d <= _limit; ++d) {
+
+        // the main thread starts no more iterations when told
+        if (w.id == 0 && d > 1 && __atomic_load_n(&_next, __ATOMIC_RELAXED)) {
+            break;
+        }
+
+        // helpers skip some of the depths
+        if (w.id > 0) {
+            int             i = (w.id - 1) % _skips;
+            if (((d + _skipPhase[i]) / _skipSize[i]) % 2) {
+                continue;
+            }
+        }
+
+        Evaluation::Eval    v = _aspire(w, d, w.value, 0);
+        if (stopped()) {
+            break;
+        }
+
+        __atomic_store_n(&w.best, w.root[0], __ATOMIC_RELAXED);
+        w.value = v;
+        w.depth = d;
+        w.line.setsz(0);
+        for (int i = 0; i < w.length[0]; ++i) {
+            w.line.add(w.pv[0][i]);
+        }
+        if (w.line.vsize() == 0) {
+            w.line.add(w.root[0]);
+        }
+
+        if (w.id == 0) {
+            _multi(w, d);
+        }
+
+    }
+
+}
+
+
+
+/**
+ * Search the root moves from the index by the aspiration window
+ * From AspirationDepth, the window is centered on the value given and
+ * doubled on the side the value falls out, until the value fits in.
+ * @param w thread
+ * @param d depth to search
+ * @param center value of the last iteration
+ * @param first index of the first root move searched
+ * @return value of the best move from the index
+ */
+Evaluation::Eval Search::_aspire (Worker &w, int d, Evaluation::Eval center,
+                                  size_t first)
+{
+
+    Evaluation::Eval        alpha = -Evaluation::Infinity;
+    Evaluation::Eval        beta  =  Evaluation::Infinity;
+    Evaluation::Eval        delta = AspirationWindow;
+    if (d >= AspirationDepth) {
+        alpha = std::max(center - delta, -Evaluation::Infinity);
+        beta  = std::min(center + delta,  Evaluation::Infinity);
+    }
+
+    Evaluation::Eval        v;
+    while (1) {
+        v = _root(w, d, alpha, beta, first);
+        if (stopped()) {
+            break;
+        }
+        delta *= 2;
+        if (v <= alpha && alpha > -Evaluation::Infinity) {
+            alpha = std::max(v - delta, -Evaluation::Infinity);
+        } else
+        if (v >= beta  && beta  <  Evaluation::Infinity) {
+            beta  = std::min(v + delta,  Evaluation::Infinity);
+        } else {
+            break;
+        }
+    }
+
+    return v;
+
+}
+
+
+
+/**
+ * Search the lines after the best one (MultiPV)
+ * The best line of the iteration is already at the head of the root
+ * moves. The root is searched again from the next index for each line,
+ * so the moves reported are excluded. The best line stays first as it
+ * is of the move played, and the others are kept in the order of their
+ * values. The lines are kept when all of them complete.
+ * @param w main thread
+ * @param d depth of the iteration
+ */
+void Search::_multi (Worker &w, int d)
+{
+
+    int                     n = static_cast<int>(
+                                    std::min(static_cast<size_t>(_pvs),
+                                             w.root.vsize()));
+
+    _record(w, 0, d, w.value);
+    report(0, _found[0]);
+
+    for (int i = 1; i < n; ++i) {
+        Evaluation::Eval    c = i < _nlines ? _lines[i].value : w.value;
+        Evaluation::Eval    v = _aspire(w, d, c, i);
+        if (stopped()) {
+            return;
+        }
+        _record(w, i, d, v);
+
+        // the values of the lines searched apart may be out of order, and
+        // the line is put in order after the best one
+        int                 j = i;
+        Line                l = _found[i];
+        Move::Move          m = w.root[i];
+        for (; j > 1 && _found[j - 1].value < v; --j) {
+            _found[j] = _found[j - 1];
+            w.root[j] = w.root[j - 1];
+        }
+        _found[j] = l;
+        w.root[j] = m;
+        report(j, _found[j]);
+    }
+
+    for (int i = 0; i < n; ++i) {
+        _lines[i] = _found[i];
+    }
+    _nlines = n;
+
+}
+
+
+
+/**
+ * Record the principal variation found at the root
+ * @param w main thread
+ * @param i rank of the line
+ * @param d depth searched
+ * @param v value of the line
+ */
+void Search::_record (Worker &w, int i, int d, Evaluation::Eval v)
+{
+
+    Line &                  l = _found[i];
+
+    struct timespec         t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    uint64_t                ms = static_cast<uint64_t>(
+                                     (t.tv_sec  - _begin.tv_sec ) * 1000 +
+                                     (t.tv_nsec - _begin.tv_nsec) / 1000000);
+
+    l.pv.setsz(0);
+    for (int j = 0; j < w.length[0]; ++j) {
+        l.pv.add(w.pv[0][j]);
+    }
+    if (l.pv.vsize() == 0) {
+        l.pv.add(w.root[i]);
+    }
+    l.value = v;
+    l.depth = d;
+    l.nodes = nodes();
+    l.nps   = l.nodes * 1000 / std::max<uint64_t>(ms, 1);
+
+}
+
+
+
+/**
+ * Search the root moves from the index in the window
+ * The best move is moved to the index unless all the moves fail low. The
+ * moves before the index are excluded, so the value is not of the root
+ * and is not stored in the table then.
+ * @param w thread
+ * @param depth depth to search
+ * @param alpha lower bound
+ * @param beta upper bound
+ * @param first index of the first move searched
+ * @return value of the best move (fail-soft)
+ */
+Evaluation::Eval Search::_root (Worker &w, int depth,
+                                Evaluation::Eval alpha, Evaluation::Eval beta,
+                                size_t first)
+{
+
+    Position &              p     = w.position;
+    Evaluation::Eval        a0    = alpha;
+    Evaluation::Eval        vmax  = -Evaluation::Infinity;
+    size_t                  best  = first;
+
+    _count(w);
+    w.length[0] = 0;
+
+    for (size_t i = first; i < w.root.vsize(); ++i) {
+        auto                back  = p.move(w.root[i]);
+        Evaluation::Eval    v     = _child(w, alpha, beta, depth - 1, 1,
+                                           i == first);
+        p.undo(back);
+        if (stopped()) {
+            return vmax;
+        }
+        if (v > vmax) {
+            vmax = v;
+            best = i;
+            if (v > alpha) {
+                alpha = v;
+                _update(w, 0, w.root[i]);
+                if (v >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+
+    if (vmax <= a0) {
+        if (first == 0) {
+            _table.store(_key(p), _verifier(p), Move::None, vmax, 0, depth,
+                         TranspositionTable::Upper);
+        }
+        return vmax;
+    }
+
+    // the best move first
+    Move::Move              m     = w.root[best];
+    for (size_t i = best; i > first; --i) {
+        w.root[i] = w.root[i - 1];
+    }
+    w.root[first] = m;
+
+    if (first > 0) {
+        return vmax;
+    }
+    _table.store(_key(p), _verifier(p), m, vmax, 0, depth,
+                 vmax >= beta ? TranspositionTable::Lower :
+                                TranspositionTable::Exact);
+
+    return vmax;
+
+}
+
+
+
+/**
+ * Search the node
+ * The move in the transposition table is searched first. The result is
+ * not stored when the search is stopped, as it may be incomplete.
+ * @param w thread
+ * @param alpha lower bound
+ * @param beta upper bound
+ * @param depth remaining depth
+ * @param ply distance from the root
+ * @return value from the side to move
+ */
+Evaluation::Eval Search::_search (Worker &w, Evaluation::Eval alpha,
+                                  Evaluation::Eval beta, int depth, int ply)
+{
+
+    if (depth <= 0) {
+        return _quiesce(w, alpha, beta, 0, ply);
+    }
+
+    Position &              p    = w.position;
+    Move::Move              prev = p.lastMove();
+    _count(w);
+    w.length[ply] = ply;
+
+    if (_aborted(w)) {
+        return 0;
+    }
+
+    // the last move left OU in check, which dusty() cannot find among the
+    // evasions
+    if (p.nchecks() > 0 && p.exposed()) {
+        return Evaluation::Infinity;
+    }
+
+    // transposition table, which cuts only off the principal variation
+    // not to cut the variation short (the reply is expected of it)
+    bool                    pv   = beta - alpha > 1;
+    Zobrist::key            k    = _key(p);
+    Zobrist::key            v    = _verifier(p);
+    Move::Move              hash = Move::None;
+    TranspositionTable::Entry e;
+    if (_table.probe(k, v, e)) {
+        hash = e.move();
+        if (e.depth() >= depth && ! pv) {
+            Evaluation::Eval t = e.value();
+            if (e.bound() == TranspositionTable::Exact ||
+                (e.bound() == TranspositionTable::Lower && t >= beta) ||
+                (e.bound() == TranspositionTable::Upper && t <= alpha)) {
+                return t;
+            }
+        }
+    }
+
+    if (ply >= MaxPly - 1) {
+        return evaluate(p);
+    }
+
+    // the nodes off the principal variation are pruned by the static
+    // evaluation unless in check or near the mates
+    bool                    check = p.nchecks() > 0;
+    Evaluation::Eval        se    = check ? 0 : evaluate(p);
+    bool                    prune = ! pv && ! check && std::abs(beta) < Mate;
+    bool                    futile = false;
+    Evaluation::Eval        fbound = -Evaluation::Infinity;
+    if (prune) {
+        // razoring, a node far below alpha is left to the quiescence
+        if (depth <= _params[Parameters::RazorDepth] &&
+            se + _params[Parameters::RazorMargin] * depth <= alpha) {
+            Evaluation::Eval t = _quiesce(w, alpha, alpha + 1, 0, ply);
+            if (t <= alpha) {
+                return t;
+            }
+        }
+        // futility pruning, a node far above beta cuts off by itself, and
+        // the quiet moves of a node far below alpha are not searched
+        if (depth <= _params[Parameters::FutilityDepth]) {
+            int             margin = _params[Parameters::FutilityMargin]
+                                   * depth;
+            if (se - margin >= beta) {
+                return p.exposed() ? Evaluation::Infinity : se;
+            }
+            futile = se + margin <= alpha;
+            fbound = se + margin;
+        }
+    }
+
+    Moves                   m;
+    p.genFast(m);
+
+    // the move in the table first, and the others by the heuristics
+    w.history.score(p, m, ply, prev);
+    if (hash != Move::None) {
+        for (auto &move : m) {
+            if ((move & Move::MoveMask) == hash) {
+                move = Move::setValue(Move::ValueOffset - 1, hash);
+                break;
+            }
+        }
+    }
+
+    // multi-cut, the node is taken for a cutoff when several of the first
+    // moves cut off by a shallower search
+    if (prune && depth >= _params[Parameters::MultiCutDepth]) {
+        size_t              n    = std::min(m.vsize(), static_cast<size_t>(
+                                        _params[Parameters::MultiCutMoves]));
+        int                 cuts = 0;
+        for (size_t i = 0; i < n; ++i) {
+            _order(m, i);
+            Move::Move      move = m[i];
+            if (p.dusty(move)) {
+                return Evaluation::Infinity;
+            }
+            auto            back = p.move(move);
+            Evaluation::Eval t   = -_search(w, -beta, -beta + 1, depth - 1 -
+                                        _params[Parameters::MultiCutReduction],
+                                        ply + 1);
+            p.undo(back);
+            if (_aborted(w)) {
+                return 0;
+            }
+            if (t >= beta && ++cuts >= _params[Parameters::MultiCutCuts]) {
+                return beta;
+            }
+        }
+    }
+
+    Evaluation::Eval        a0   = alpha;
+    Evaluation::Eval        vmax = -Evaluation::Infinity;
+    Move::Move              bm   = Move::None;
+    Move::Move              tried[MaxPly];
+    int                     quiets = 0;
+    bool                    pruned = false;
+
+    for (size_t i = 0; i < m.vsize(); ++i) {
+
+        _order(m, i);
+        Move::Move          move = m[i];
+
+        // the last move left OU to be captured
+        if (p.dusty(move)) {
+            return Evaluation::Infinity;
+        }
+
+        bool                quiet = History::quiet(p, move);
+        auto                back  = p.move(move);
+        bool                gives = p.nchecks() > 0;
+
+        // futility pruning of the quiet moves
+        if (futile && quiet && ! gives && i > 0) {
+            p.undo(back);
+            pruned = true;
+            continue;
+        }
+
+        // late move reduction of the quiet moves
+        int                 r     = 0;
+        if (quiet && ! check && ! gives) {
+            r = _reduction(depth, i, pv);
+        }
+
+        Evaluation::Eval    t     = _child(w, alpha, beta, depth - 1, ply + 1,
+                                           i == 0, r);
+        p.undo(back);
+
+        if (_aborted(w)) {
+            return 0;
+        }
+
+        if (t > vmax) {
+            vmax = t;
+            bm   = move;
+            if (t > alpha) {
+                alpha = t;
+                _update(w, ply, move);
+                if (t >= beta) {
+                    if (quiet) {
+                        w.history.good(p.turn(), move, tried, quiets,
+                                       ply, depth, prev);
+                    }
+                    break;
+                }
+            }
+        }
+        if (quiet && quiets < MaxPly) {
+            tried[quiets++] = move;
+        }
+
+        // the eldest brother searched, share the younger ones
+        if (i == 0 && _scheduler == YBWC && depth >= SplitDepth &&
+            m.vsize() > 1 && w.tail < MaxPly &&
+            __atomic_load_n(&_idlers, __ATOMIC_RELAXED) > 0) {
+            _sort(m, 1);
+            if (! _split(w, m, alpha, beta, vmax, bm, depth, ply)) {
+                return Evaluation::Infinity;
+            }
+            if (_aborted(w)) {
+                return 0;
+            }
+            break;
+        }
+
+    }
+
+    // the moves pruned are taken for the static bound, not for a mate
+    if (pruned) {
+        vmax = std::max(vmax, fbound);
+    }
+
+    TranspositionTable::Bound b =
+        vmax >= beta ? TranspositionTable::Lower :
+        vmax >  a0   ? TranspositionTable::Exact :
+                       TranspositionTable::Upper;
+    _table.store(k, v, bm, vmax, se, depth, b);
+
+    return vmax;
+
+}
+
+
+
+/**
+ * Search the child by a zero window, and by the window when it fails high
+ * (principal variation search). The eldest brother is expected to be the
+ * best and is searched by the window. The younger ones are only proved
+ * to be worse than it by the zero window scout, which cuts far more, and
+ * searched again when the proof fails. The nodes off the principal
+ * variation have a zero window already, so they never search again.
+ * A late move to be reduced is searched shallower by the zero window
+ * first, and searched again in full only when it raises alpha.
+ * @param w thread
+ * @param alpha lower bound of the parent
+ * @param beta upper bound of the parent
+ * @param depth remaining depth of the child
+ * @param ply distance of the child from the root
+ * @param first true for the eldest brother
+ * @param r depth reduced
+ * @return value of the move from the parent
+ */
+Evaluation::Eval Search::_child (Worker &w, Evaluation::Eval alpha,
+                                 Evaluation::Eval beta, int depth, int ply,
+                                 bool first, int r)
+{
+
+    if (r > 0) {
+        Evaluation::Eval    t = -_search(w, -alpha - 1, -alpha, depth - r,
+                                         ply);
+        if (t <= alpha || _aborted(w)) {
+            return t;
+        }
+    }
+
+    if (first || beta - alpha <= 1) {
+        return -_search(w, -beta, -alpha, depth, ply);
+    }
+
+    Evaluation::Eval        t = -_search(w, -alpha - 1, -alpha, depth, ply);
+    if (t > alpha && t < beta && ! _aborted(w)) {
+        t = -_search(w, -beta, -alpha, depth, ply);
+    }
+
+    return t;
+
+}
+
+
+
+/**
+ * Search the younger brothers with the idle threads
+ * The node is pushed on the deque of the thread, and the owner searches
+ * the moves left together with the thieves. The owner waits for all the
+ * thieves before returning, as they refer to the split point on its stack.
+ * @param w thread owning the node
+ * @param m moves at the node (the first one has been searched)
+ * @param alpha lower bound, updated
+ * @param beta upper bound
+ * @param vmax value of the best move, updated
+ * @param bm best move, updated
+ * @param depth remaining depth
+ * @param ply distance from the root
+ * @return false if a move captures OU (the last move was illegal)
+ */
+bool Search::_split (Worker &w, Moves &m, Evaluation::Eval &alpha,
+                     Evaluation::Eval beta, Evaluation::Eval &vmax,
+                     Move::Move &bm, int depth, int ply)
+{
+
+    // the thieves never see a move capturing OU
+    for (size_t i = 1; i < m.vsize(); ++i) {
+        if (w.position.dusty(m[i])) {
+            return false;
+        }
+    }
+
+    SplitPoint              sp;
+    sp.parent   = w.split;
+    sp.position = w.position;
+    sp.moves    = m;
+    sp.next     = 1;
+    sp.helpers  = 0;
+    sp.cutoff   = 0;
+    sp.alpha    = alpha;
+    sp.beta     = beta;
+    sp.best     = vmax;
+    sp.move     = bm;
+    sp.depth    = depth;
+    sp.ply      = ply;
+    sp.length   = w.length[ply];
+    for (int i = ply; i < sp.length; ++i) {
+        sp.pv[i] = w.pv[ply][i];
+    }
+
+    {
+        foundation::SpinLock l(w.lock);
+        w.deque[w.tail++] = &sp;
+    }
+
+    w.split = &sp;
+    _work(w, sp);
+
+    // no more thieves, and wait for the ones working
+    {
+        foundation::SpinLock l(w.lock);
+        --w.tail;
+    }
+    while (__atomic_load_n(&sp.helpers, __ATOMIC_ACQUIRE) > 0) {
+        sched_yield();
+    }
+    w.split = sp.parent;
+
+    alpha = sp.alpha;
+    vmax  = sp.best;
+    bm    = sp.move;
+    w.length[ply] = sp.length;
+    for (int i = ply; i < sp.length; ++i) {
+        w.pv[ply][i] = sp.pv[i];
+    }
+
+    return true;
+
+}
+
+
+
+/**
+ * Search the moves of the split point
+ * The owner and the thieves take the moves one by one until they run out
+ * or a cutoff occurs.
+ * @param w thread
+ * @param sp split point
+ */
+void Search::_work (Worker &w, SplitPoint &sp)
+{
+
+    Position &              p = w.position;
+
+    while (! _aborted(w)) {
+
+        int                 i = __atomic_fetch_add(&sp.next, 1,
+                                                   __ATOMIC_RELAXED);
+        if (i >= static_cast<int>(sp.moves.vsize())) {
+            break;
+        }
+
+        Move::Move          move  = sp.moves[i];
+        Evaluation::Eval    alpha = __atomic_load_n(&sp.alpha,
+                                                    __ATOMIC_RELAXED);
+        bool                quiet = History::quiet(p, move);
+        bool                check = p.nchecks() > 0;
+        auto                back  = p.move(move);
+        int                 r     = 0;
+        if (quiet && ! check && p.nchecks() == 0) {
+            r = _reduction(sp.depth, i, sp.beta - alpha > 1);
+        }
+        Evaluation::Eval    t     = _child(w, alpha, sp.beta, sp.depth - 1,
+                                           sp.ply + 1, false, r);
+        p.undo(back);
+
+        if (_aborted(w)) {
+            break;
+        }
+
+        foundation::SpinLock l(sp.lock);
+        if (t > sp.best) {
+            sp.best = t;
+            sp.move = move;
+            if (t > sp.alpha) {
+                __atomic_store_n(&sp.alpha, t, __ATOMIC_RELAXED);
+                _update(w, sp.ply, move);
+                sp.length = w.length[sp.ply];
+                for (int j = sp.ply; j < sp.length; ++j) {
+                    sp.pv[j] = w.pv[sp.ply][j];
+                }
+                if (t >= sp.beta) {
+                    __atomic_store_n(&sp.cutoff, 1, __ATOMIC_RELAXED);
+                }
+            }
+        }
+
+    }
+
+}
+
+
+
+/**
+ * Steal the work from the other threads
+ * The deques are scanned from the head, so the thief takes the split
+ * point nearest to the root having moves left.
+ * @param w thief
+ * @return split point joined (nullptr if none)
+ */
+Search::SplitPoint * Search::_steal (Worker &w)
+{
+
+    for (int k = 1; k < _threads; ++k) {
+        Worker &            v = *_worker[(w.id + k) % _threads];
+        foundation::SpinLock l(v.lock);
+        for (int i = 0; i < v.tail; ++i) {
+            SplitPoint *    sp = v.deque[i];
+            if (__atomic_load_n(&sp->next, __ATOMIC_RELAXED) <
+                    static_cast<int>(sp->moves.vsize()) &&
+                ! __atomic_load_n(&sp->cutoff, __ATOMIC_RELAXED)) {
+                __atomic_add_fetch(&sp->helpers, 1, __ATOMIC_RELAXED);
+                return sp;
+            }
+        }
+    }
+
+    return nullptr;
+
+}
+
+
+
+/**
+ * Loop of the idle thief
+ * The thread keeps stealing until the search is stopped.
+ * @param w thief
+ */
+void Search::_thief (Worker &w)
+{
+
+    w.split = nullptr;
+
+    __atomic_add_fetch(&_idlers, 1, __ATOMIC_RELAXED);
+
+    while (! stopped()) {
+
+        SplitPoint *        sp = _steal(w);
+        if (sp == nullptr) {
+            sched_yield();
+            continue;
+        }
+
+        __atomic_sub_fetch(&_idlers, 1, __ATOMIC_RELAXED);
+        w.position = sp->position;
+        w.split    = sp;
+        _work(w, *sp);
+        w.split    = nullptr;
+        __atomic_sub_fetch(&sp->helpers, 1, __ATOMIC_RELEASE);
+        __atomic_add_fetch(&_idlers, 1, __ATOMIC_RELAXED);
+
+    }
+
+    __atomic_sub_fetch(&_idlers, 1, __ATOMIC_RELAXED);
+
+}
+
+
+
+/**
+ * Search the capturing moves
+ * The static evaluation works as the lower bound (stand pat), and the
+ * capturing moves are searched while they can raise it, up to QuiesPly
+ * plies beyond the depth. The last move is checked first, as the moves
+ * come from Position::genFast() and may leave OU in check.
+ * @param w thread
+ * @param alpha lower bound
+ * @param beta upper bound
+ * @param depth remaining depth (zero or negative)
+ * @param ply distance from the root
+ * @return value from the side to move
+ */
+Evaluation::Eval Search::_quiesce (Worker &w, Evaluation::Eval alpha,
+                                   Evaluation::Eval beta, int depth,
+                                   int ply)
+{
+
+    Position &              p    = w.position;
+    _count(w);
+    w.length[ply] = ply;
+
+    // the last move left OU in check, which must be found before standing
+    // pat not to take the illegal move for a quiet one
+    if (p.exposed()) {
+        return Evaluation::Infinity;
+    }
+
+    Evaluation::Eval        vmax = evaluate(p);
+    if (vmax >= beta || depth <= -QuiesPly || _aborted(w)) {
+        return vmax;
+    }
+    if (vmax > alpha) {
+        alpha = vmax;
+    }
+
+    Moves                   m;
+    p.genCapt(m);
+    w.history.score(p, m, ply, Move::None);
+
+    for (size_t i = 0; i < m.vsize(); ++i) {
+
+        m.dcpick(i);
+        Move::Move          move = m[i];
+        auto                back = p.move(move);
+        Evaluation::Eval    t    = -_quiesce(w, -beta, -alpha, depth - 1,
+                                             ply + 1);
+        p.undo(back);
+
+        if (t > vmax) {
+            vmax = t;
+            if (t > alpha) {
+                alpha = t;
+                if (t >= beta) {
+                    break;
+                }
+            }
+        }
+
+    }
+
+    return vmax;
+
+}
+
+
+
+/**
+ * Hash key of the position including the turn
+ * @param p position
+ * @return hash key
+ */
+Zobrist::key Search::_key (const Position &p)
+{
+
+    return p.hash() ^ (p.turn() == Color::Black ? 0 : _side);
+
+}
+
+
+
+/**
+ * Secondary hash key of the position including the turn
+ * @param p position
+ * @return secondary hash key
+ */
+Zobrist::key Search::_verifier (const Position &p)
+{
+
+    return p.verifier() ^ (p.turn() == Color::Black ? 0 : _side);
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+// end namespace 'game'
+}
@@ -0,0 +1,763 @@
+/**
+ *****************************************************************************
+
+ @file       Search.h
+
+ @brief      Parallel alpha-beta search definitions
+
+ @author     Hiroki Takada (http://wwww.tsoftware.jp/)
+
+ @date       2026-10-18
+
+ @version    $Id:$
+
+
+  Copyright 2014, 2015, 2016, 2017 Hiroki Takada
+
+  This file is part of libshogi.
+
+  libshogi is free software: you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  libshogi is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with libshogi. If not, see <http://www.gnu.org/licenses/>.
+
+
+  ----------------------------------------------------------------------------
+  RELEASE NOTE :
+
+   DATE          REV    REMARK
+  ============= ====== =======================================================
+  18th Oct 2026  0.1   Initial release
+
+ *****************************************************************************/
+
+#ifndef _GAME_SEARCH_H
+#define _GAME_SEARCH_H
+
+#include <pthread.h>
+#include <time.h>
+
+#include <Common.h>
+
+#include <Array.h>
+#include <SpinLock.h>
+#include <Position.h>
+#include <TranspositionTable.h>
+#include <History.h>
+#include <Parameters.h>
+
+// begin namespace 'game'
+namespace game {
+
+/* --------------------------- macro declaration --------------------------- */
+#ifdef  _GAME_SEARCH_DEBUG
+#define _GAME_SEARCH_CHECK(x) { assert ( (x) ); }
+#define _GAME_SEARCH_DEBUG_ERROR_STRING_MAX 256
+#define _GAME_SEARCH_DEBUG_OUT(fmt, args...)  { \
+            fprintf(stderr, "GAME_SEARCH_DEBUG     : " fmt, ## args); \
+        }
+#define _GAME_SEARCH_DEBUG_FUNCTION_RESULT(x) { \
+            char errorString_[_GAME_SEARCH_DEBUG_ERROR_STRING_MAX]; \
+            sprintf(errorString_, "%s - %s - %d", (x) , __FILE__, __LINE__); \
+            perror(errorString_); \
+        }
+#else
+#define _GAME_SEARCH_CHECK(x)
+#define _GAME_SEARCH_DEBUG_OUT(fmt, args...)
+#define _GAME_SEARCH_DEBUG_FUNCTION_RESULT(x)
+#endif
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ------------------------- search exceptions ----------------------------- */
+class SearchException {};
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ----------------------------- Search class ------------------------------ */
+
+/**
+ *  Parallel alpha-beta search (Lazy SMP)
+ *
+ *  go() searches the position by iterative deepening on the calling
+ *  thread (the main thread) and the helper threads at once. The helpers
+ *  are created by the constructor and sleep between the searches. They
+ *  search the same position independently, skipping some of the depths
+ *  so that they run ahead of the main thread, and share the results only
+ *  through the transposition table. The main thread finds the entries
+ *  they stored and cuts its tree, which is how the helpers speed it up.
+ *  No locks are taken during the search, each thread has its own copy
+ *  of the position and its own counters.
+ *
+ *  Each iteration from AspirationDepth is searched with a window around
+ *  the value of the last one, widened and searched again when the value
+ *  falls outside. The principal variation is collected in a triangular
+ *  table. best(), value() and pv() keep the results of the last iteration
+ *  completed, so a search stopped by the clock always has a move to play.
+ *
+ *  The tree is searched in the negamax form from the side to move, by
+ *  the principal variation search (PVS); only the eldest brother gets the
+ *  window, and the others are scouted by a zero window first. The
+ *  moves are generated by Position::genFast() and a move capturing OU
+ *  tells the last move was illegal. The leaves are searched by the
+ *  capturing moves until the position gets quiet. The value of the
+ *  position is given by evaluate(), which a subclass may override.
+ *
+ *  The helpers can work as the thieves of the Young Brothers Wait
+ *  Concept (YBWC) instead. Only the main thread deepens iteratively, and
+ *  a node deep enough is split after its eldest brother is searched: the
+ *  node is pushed on the deque of the thread owning it and the rest of
+ *  the moves are searched by the owner and by the idle threads stealing
+ *  them. The owner pushes and pops its own nodes at the tail, the thieves
+ *  steal from the head where the largest subtrees are. A cutoff at a
+ *  split node stops every thread working below it.
+ *
+ *  multiPV() asks the main thread for more lines than the best one. After
+ *  the best move, each iteration searches the root again for the next
+ *  line excluding the moves already reported, with the window around the
+ *  value of the line in the last iteration. The lines share the table
+ *  with the threads, and each is told to report() when found with its
+ *  depth, value, nodes and nps. line() keeps the lines of the last
+ *  iteration completed in all of them. The helpers search the best line
+ *  only.
+ *
+ *  ponder() runs the search in the background on the position after the
+ *  move expected of the opponent. ponderhit() tells the move played: the
+ *  search goes on when it was expected, and is stopped otherwise, leaving
+ *  what it found in the transposition table. wait() takes the result.
+ *  A subclass overriding evaluate() or report() must stop() and wait()
+ *  in its own destructor: the destructor of Search does it too late, as
+ *  the search in the background would call the overrides of an object
+ *  already destroyed.
+ *
+ *  The transposition table is chosen by the caller, so that the search
+ *  can share it with others or keep it across the games.
+ *
+ */
+class Search
+{
+
+public:
+
+    /// Maximum number of plies searched
+    static constexpr int    MaxPly      = 64;
+
+    /// Maximum number of plies of the capturing moves beyond the depth
+    static constexpr int    QuiesPly    = 6;
+
+    /// Maximum number of threads
+    static constexpr int    Threads     = 64;
+
+    /// Depth from which the iterations use the aspiration window
+    static constexpr int    AspirationDepth  = 4;
+
+    /// Initial half width of the aspiration window
+    static constexpr int    AspirationWindow = 50;
+
+    /// Minimum remaining depth to split a node (YBWC)
+    static constexpr int    SplitDepth  = 2;
+
+    /// Number of the moves picked one by one before sorting the rest
+    static constexpr size_t PickMoves   = 3;
+
+    /// Minimum number of the moves sorted by the radix sort
+    static constexpr size_t RadixMoves  = 64;
+
+    /// Values beyond are taken for the mates and never pruned
+    static constexpr int    Mate        = Evaluation::Infinity / 2;
+
+    /// Maximum number of the principal variations (MultiPV)
+    static constexpr int    MaxPV       = 16;
+
+    /// Moves in a position
+    using Moves             = foundation::Array<Move::Move, Move::Max>;
+
+    static_assert(MaxPly <= History::Plies, "killer moves for each ply");
+
+    /// Schedulers of the threads
+    enum Scheduler : int {
+
+        /// Threads search the whole tree sharing the table
+        LazySMP = 0,
+
+        /// Threads share the nodes after the eldest brother is searched
+        YBWC    = 1
+
+    };
+
+    /// Principal variation reported (MultiPV)
+    struct Line {
+
+        /// Moves from the root
+        Moves               pv;
+
+        /// Value of the first move (exact)
+        Evaluation::Eval    value;
+
+        /// Depth searched
+        int                 depth;
+
+        /// Number of nodes searched by all the threads when found
+        uint64_t            nodes;
+
+        /// Nodes per second
+        uint64_t            nps;
+
+    };
+
+
+
+    /// Constructor takes the table, the number of threads and the scheduler
+    Search (TranspositionTable &, int = 1, Scheduler = LazySMP);
+
+    /// Destructor (subclasses overriding evaluate or report stop first)
+    virtual ~Search ();
+
+    /// Search the position to the given depth and return the best move
+    Move::Move              go         (const Position &, int);
+
+    /// Search the position after the expected move in the background
+    bool                    ponder     (const Position &, Move::Move, int);
+
+    /// Tell the move played while pondering (true if expected)
+    bool                    ponderhit  (Move::Move);
+
+    /// Wait for the search in the background and return the best move
+    Move::Move              wait       (void);
+
+    /// Check if the search is running in the background
+    bool                    pondering  (void)                       const;
+
+    /// Expected move being pondered
+    Move::Move              expected   (void)                       const;
+
+    /// Stop the search (from another thread)
+    void                    stop       (void);
+
+    /// Stop the search before the next iteration (from another thread)
+    void                    stopNext   (void);
+
+    /// Check if the search is stopped
+    bool                    stopped    (void)                       const;
+
+    /// Best move of the last iteration completed
+    Move::Move              best       (void)                       const;
+
+    /// Value of the best move
+    Evaluation::Eval        value      (void)                       const;
+
+    /// Depth of the last iteration completed
+    int                     depth      (void)                       const;
+
+    /// Principal variation of the last iteration completed
+    Moves                   pv         (void)                       const;
+
+    /// Number of nodes searched by all the threads
+    uint64_t                nodes      (void)                       const;
+
+    /// Set the number of the principal variations (MultiPV)
+    void                    multiPV    (int);
+
+    /// Number of the principal variations asked
+    int                     multiPV    (void)                       const;
+
+    /// Number of the lines of the last iteration completed
+    int                     lines      (void)                       const;
+
+    /// Line of the rank given (0 for the best)
+    Line                    line       (int)                        const;
+
+    /// Number of threads
+    int                     threads    (void)                       const;
+
+    /// Scheduler of the threads
+    Scheduler               scheduler  (void)                       const;
+
+    /// Parameters of the pruning (to be changed between the searches)
+    Parameters &            parameters (void);
+
+    /// Parameters of the pruning
+    const Parameters &      parameters (void)                       const;
+
+protected:
+
+    /// Evaluate the position from the side to move
+    virtual Evaluation::Eval evaluate  (Position &);
+
+    /// Report the line of the rank found by the main thread
+    virtual void            report     (int, const Line &);
+
+private:
+
+    struct Worker;
+
+    /// Node shared by the threads (YBWC)
+    struct SplitPoint {
+
+        /// Split point the owner was working for
+        SplitPoint *        parent;
+
+        /// Position at the node
+        Position            position;
+
+        /// Moves at the node
+        Moves               moves;
+
+        /// Index of the next move to search
+        int                 next;
+
+        /// Number of thieves working on the node
+        int                 helpers;
+
+        /// Flag telling a cutoff
+        int                 cutoff;
+
+        /// Lower bound
+        Evaluation::Eval    alpha;
+
+        /// Upper bound
+        Evaluation::Eval    beta;
+
+        /// Value of the best move so far
+        Evaluation::Eval    best;
+
+        /// Best move so far
+        Move::Move          move;
+
+        /// Principal variation from the node
+        Move::Move          pv[MaxPly];
+
+        /// End of the principal variation
+        int                 length;
+
+        /// Remaining depth
+        int                 depth;
+
+        /// Distance from the root
+        int                 ply;
+
+        /// Lock for the best move and the bounds
+        foundation::SpinLockObject lock;
+
+    };
+
+    /// Search thread
+    struct Worker {
+
+        /// Search owning the thread
+        Search *            search;
+
+        /// Thread number (0 for the main thread)
+        int                 id;
+
+        /// Thread
+        pthread_t           thread;
+
+        /// Position searched
+        Position            position;
+
+        /// Moves at the root
+        Moves               root;
+
+        /// Number of nodes searched
+        uint64_t            nodes;
+
+        /// Best move of the last iteration completed
+        Move::Move          best;
+
+        /// Value of the best move
+        Evaluation::Eval    value;
+
+        /// Depth of the last iteration completed
+        int                 depth;
+
+        /// Principal variation of the last iteration completed
+        Moves               line;
+
+        /// Move ordering heuristics
+        History             history;
+
+        /// Triangular table of the principal variations
+        Move::Move          pv[MaxPly][MaxPly];
+
+        /// End of the principal variation at each ply
+        int                 length[MaxPly];
+
+        /// Split point the thread is working for
+        SplitPoint *        split;
+
+        /// Split points owned by the thread (YBWC)
+        SplitPoint *        deque[MaxPly];
+
+        /// Number of the split points owned
+        int                 tail;
+
+        /// Lock for the deque
+        foundation::SpinLockObject lock;
+
+    };
+
+    /// Helper thread
+    static void *           _helper    (void *);
+
+    /// Main thread of the search pondering
+    static void *           _ponder    (void *);
+
+    /// Start the search
+    void                    _start     (const Position &, int);
+
+    /// Finish the search
+    Move::Move              _finish    (void);
+
+    /// Callback of the moves prefetching the table
+    static void             _prefetch  (const Position &, void *);
+
+    /// Iterative deepening
+    void                    _iterate   (Worker &);
+
+    /// Search the root moves from the index by the aspiration window
+    Evaluation::Eval        _aspire    (Worker &, int, Evaluation::Eval,
+                                        size_t);
+
+    /// Search the lines after the best one (MultiPV)
+    void                    _multi     (Worker &, int);
+
+    /// Record the principal variation found at the root
+    void                    _record    (Worker &, int, int,
+                                        Evaluation::Eval);
+
+    /// Search the root moves from the index in the window
+    Evaluation::Eval        _root      (Worker &, int, Evaluation::Eval,
+                                        Evaluation::Eval, size_t = 0);
+
+    /// Search the node
+    Evaluation::Eval        _search    (Worker &, Evaluation::Eval,
+                                        Evaluation::Eval, int, int);
+
+    /// Search the child by a zero window, and by the window if it fails high
+    Evaluation::Eval        _child     (Worker &, Evaluation::Eval,
+                                        Evaluation::Eval, int, int, bool,
+                                        int = 0);
+
+    /// Depth reduced for the late move
+    int                     _reduction (int, size_t, bool)          const;
+
+    /// Search the younger brothers with the idle threads
+    bool                    _split     (Worker &, Moves &,
+                                        Evaluation::Eval &, Evaluation::Eval,
+                                        Evaluation::Eval &, Move::Move &,
+                                        int, int);
+
+    /// Search the moves of the split point
+    void                    _work      (Worker &, SplitPoint &);
+
+    /// Steal the work from the other threads
+    SplitPoint *            _steal     (Worker &);
+
+    /// Loop of the idle thief
+    void                    _thief     (Worker &);
+
+    /// Check if the search of the thread is aborted
+    bool                    _aborted   (const Worker &)             const;
+
+    /// Search the capturing moves
+    Evaluation::Eval        _quiesce   (Worker &, Evaluation::Eval,
+                                        Evaluation::Eval, int, int);
+
+    /// Update the principal variation at the ply with the move
+    static void             _update    (Worker &, int, Move::Move);
+
+    /// Hash key of the position including the turn
+    static Zobrist::key     _key       (const Position &);
+
+    /// Secondary hash key of the position including the turn
+    static Zobrist::key     _verifier  (const Position &);
+
+    /// Count the node
+    static void             _count     (Worker &);
+
+    /// Sort the moves from the index by the ordering scores
+    static void             _sort      (Moves &, size_t);
+
+    /// Bring the move of the index in order
+    static void             _order     (Moves &, size_t);
+
+    /// void copy constructor
+    Search (const Search &);
+
+    /// void copy
+    Search &                operator=  (const Search &);
+
+    /// Transposition table
+    TranspositionTable &    _table;
+
+    /// Threads
+    Worker *                _worker[Threads];
+
+    /// Number of threads
+    int                     _threads;
+
+    /// Scheduler of the threads
+    Scheduler               _scheduler;
+
+    /// Number of thieves idle
+    int                     _idlers;
+
+    /// Position to search
+    const Position *        _position;
+
+    /// Depth to search
+    int                     _limit;
+
+    /// Parameters of the pruning
+    Parameters              _params;
+
+    /// Late move reductions by the depth and the number of the moves
+    int                     _reductions[MaxPly][MaxPly];
+
+    /// Number of the principal variations asked
+    int                     _pvs;
+
+    /// Lines of the last iteration completed
+    Line                    _lines[MaxPV];
+
+    /// Number of the lines above
+    int                     _nlines;
+
+    /// Lines of the iteration searching
+    Line                    _found[MaxPV];
+
+    /// Time the search started
+    struct timespec         _begin;
+
+    /// Flag stopping the search
+    int                     _stop;
+
+    /// Flag stopping the search before the next iteration
+    int                     _next;
+
+    /// Serial number of the searches
+    unsigned                _task;
+
+    /// Number of helpers searching
+    int                     _running;
+
+    /// Flag terminating the helpers
+    bool                    _quit;
+
+    /// Lock for the states above
+    pthread_mutex_t         _lock;
+
+    /// Condition to wake the helpers
+    pthread_cond_t          _wake;
+
+    /// Condition to tell the helpers finished
+    pthread_cond_t          _idle;
+
+    /// Position pondered (after the expected move)
+    Position                _pondered;
+
+    /// Expected move
+    Move::Move              _expected;
+
+    /// Flag telling the search is running in the background
+    bool                    _pondering;
+
+    /// Main thread of the search pondering
+    pthread_t               _ponderer;
+
+};
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ---------------------------- implementations ---------------------------- */
+
+/**
+ * Stop the search
+ * go() returns the best move of the last iteration completed.
+ */
+inline void Search::stop (void)
+{
+
+    __atomic_store_n(&_stop, 1, __ATOMIC_RELAXED);
+
+}
+
+
+
+/**
+ * Stop the search before the next iteration starts
+ * The iteration searching goes on to the end, which spends no time on an
+ * iteration unlikely to complete.
+ */
+inline void Search::stopNext (void)
+{
+
+    __atomic_store_n(&_next, 1, __ATOMIC_RELAXED);
+
+}
+
+
+
+/**
+ * Check if the search is stopped
+ * @return true if stopped
+ */
+inline bool Search::stopped (void) const
+{
+
+    return __atomic_load_n(&_stop, __ATOMIC_RELAXED) != 0;
+
+}
+
+
+
+/**
+ * Check if the search of the thread is aborted
+ * The search is aborted by stop() or a cutoff at any of the split points
+ * the thread is working for.
+ * @param w thread
+ * @return true if aborted
+ */
+inline bool Search::_aborted (const Worker &w) const
+{
+
+    if (stopped()) {
+        return true;
+    }
+    for (auto sp = w.split; sp != nullptr; sp = sp->parent) {
+        if (__atomic_load_n(&sp->cutoff, __ATOMIC_RELAXED)) {
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+
+
+/**
+ * Update the principal variation at the ply with the move
+ * The move is followed by the principal variation of the next ply.
+ * @param w thread
+ * @param ply distance from the root
+ * @param m move raising the lower bound
+ */
+inline void Search::_update (Worker &w, int ply, Move::Move m)
+{
+
+    Move::Move *            pv = w.pv[ply];
+    const Move::Move *      cv = w.pv[ply + 1];
+    int                     n  = w.length[ply + 1];
+
+    pv[ply] = static_cast<Move::Move>(m & Move::MoveMask);
+    for (int i = ply + 1; i < n; ++i) {
+        pv[i] = cv[i];
+    }
+    w.length[ply] = n > ply + 1 ? n : ply + 1;
+
+}
+
+
+
+/**
+ * Count the node
+ * The counter is read by other threads while searching.
+ * @param w thread
+ */
+inline void Search::_count (Worker &w)
+{
+
+    __atomic_store_n(&w.nodes, w.nodes + 1, __ATOMIC_RELAXED);
+
+}
+
+
+
+/**
+ * Sort the moves from the index by the ordering scores
+ * A few moves are sorted by insertion, and many by the radix sort on the
+ * scores in the upper 16 bits, which takes a linear time.
+ * @param m moves
+ * @param from index of the first move sorted
+ */
+inline void Search::_sort (Moves &m, size_t from)
+{
+
+    if (from + RadixMoves <= m.vsize()) {
+        m.rdsort(from);
+    } else {
+        m.dcsort(from);
+    }
+
+}
+
+
+
+/**
+ * Bring the move of the index in order
+ * The first moves are picked as they are likely to cut off, and the rest
+ * are sorted once. The moves already in order stay.
+ * @param m moves
+ * @param i index
+ */
+inline void Search::_order (Moves &m, size_t i)
+{
+
+    if (i < PickMoves) {
+        m.dcpick(i);
+    } else
+    if (i == PickMoves) {
+        _sort(m, i);
+    }
+
+}
+
+
+
+/**
+ * Depth reduced for the late move
+ * The moves before LMRMoves and the nodes shallower than LMRDepth are
+ * not reduced, and the principal variation is reduced a ply less. The
+ * child is searched at least a ply deep.
+ * @param depth remaining depth of the node
+ * @param i index of the move
+ * @param pv true on the principal variation
+ * @return plies reduced
+ */
+inline int Search::_reduction (int depth, size_t i, bool pv) const
+{
+
+    if (depth < _params[Parameters::LMRDepth] ||
+        i < static_cast<size_t>(_params[Parameters::LMRMoves])) {
+        return 0;
+    }
+
+    int                     r = _reductions[std::min(depth, MaxPly - 1)]
+                                           [std::min(i, static_cast<size_t>(
+                                                            MaxPly - 1))]
+                              - (pv ? 1 : 0);
+
+    return std::max(0, std::min(r, depth - 2));
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+// end namespace 'game'
+}
+
+#endif
@@ -0,0 +1,261 @@
+/**
+ *****************************************************************************
+
+ @file       TimeManager.cpp
+
+ @brief      Time manager implementation
+
+ @author     Hiroki Takada (http://wwww.tsoftware.jp/)
+
+ @date       2026-10-18
+
+ @version    $Id:$
+
+
+  Copyright 2014, 2015, 2016, 2017 Hiroki Takada
+
+  This file is part of libshogi.
+
+  libshogi is free software: you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  libshogi is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with libshogi. If not, see <http://www.gnu.org/licenses/>.
+
+
+  ----------------------------------------------------------------------------
+  RELEASE NOTE :
+
+   DATE          REV    REMARK
+  ============= ====== =======================================================
+  18th Oct 2026  0.1   Initial release
+
+ *****************************************************************************/
+
+#include <climits>
+
+#include <TimeManager.h>
+
+// begin namespace 'game'
+namespace game {
+
+/* ---------------------------- implementations ---------------------------- */
+
+/**
+ * Constructor (no time control, the limits are unbounded)
+ *
+ */
+TimeManager::TimeManager () :
+    _remaining(0), _byoyomi(0), _increment(0), _delay(0), _least(0),
+    _roundup(false), _unit(1000), _control(false), _soft(LONG_MAX / 2),
+    _hard(LONG_MAX / 2), _changes(0), _best(Move::None), _before(0)
+{
+
+    clock_gettime(CLOCK_MONOTONIC, &_start);
+
+}
+
+
+
+/**
+ * Constructor takes the time control of the game
+ * @param s CSA game summary
+ */
+TimeManager::TimeManager (const CSASummary &s) : TimeManager()
+{
+
+    set(s);
+
+}
+
+
+
+/**
+ * Set the time control of the game
+ * The fields not given (negative) are taken for zero, and the game
+ * having neither the total time nor the byoyomi is not controlled.
+ * @param s CSA game summary
+ */
+void TimeManager::set (const CSASummary &s)
+{
+
+    long                    u = s.timeUnit == CSASummary::MSECND ?     1 :
+                                s.timeUnit == CSASummary::MINUIT ? 60000 :
+                                                                    1000;
+    if (s.unit > 0) {
+        u *= s.unit;
+    }
+
+    set(std::max(s.totalTime, 0) * u, std::max(s.byoyomi  , 0) * u,
+        std::max(s.increment, 0) * u, std::max(s.delay    , 0) * u,
+        std::max(s.leastTime, 0) * u, s.timeRoundup == "YES", u);
+
+    _control = s.totalTime >= 0 || s.byoyomi > 0;
+
+}
+
+
+
+/**
+ * Set the time control in milli seconds
+ * @param total total time
+ * @param byoyomi byoyomi
+ * @param increment increment per move
+ * @param delay delay not charged
+ * @param least least time charged per move
+ * @param roundup true to round the time charged up to the unit
+ * @param unit unit of the time charged
+ */
+void TimeManager::set (long total, long byoyomi, long increment, long delay,
+                       long least, bool roundup, long unit)
+{
+
+    _remaining = total;
+    _byoyomi   = byoyomi;
+    _increment = increment;
+    _delay     = delay;
+    _least     = least;
+    _roundup   = roundup;
+    _unit      = unit > 0 ? unit : 1;
+    _control   = true;
+    _before    = total;
+
+}
+
+
+
+/**
+ * Start the clock of the move
+ * The soft limit is the share of the time left plus the time given every
+ * move, and is never less than the least time charged, which is free.
+ * The hard limit is the time left plus the byoyomi less the margin for
+ * the network (covered by the delay not charged), and is never more than
+ * HardRatio times the soft limit.
+ */
+void TimeManager::start (void)
+{
+
+    clock_gettime(CLOCK_MONOTONIC, &_start);
+    _changes = 0;
+    _best    = Move::None;
+
+    if (! _control) {
+        _soft = _hard = LONG_MAX / 2;
+        return;
+    }
+
+    long                    margin = std::max(Margin - _delay, 0L);
+    long                    limit  = std::max(_remaining + _byoyomi - margin,
+                                              0L);
+
+    _soft = _remaining / MovesToGo + _increment + _byoyomi;
+    _soft = std::max(_soft, _least);
+    _soft = std::min(_soft, limit);
+    _hard = std::min(_soft * HardRatio, limit);
+
+}
+
+
+
+/**
+ * Tell the best move of the search
+ * The changes are counted from StableDepth, as the shallow iterations
+ * change their minds anyway.
+ * @param m best move of the last iteration completed
+ * @param depth depth of the last iteration completed
+ * @return true if the move changed
+ */
+bool TimeManager::update (Move::Move m, int depth)
+{
+
+    m = static_cast<Move::Move>(m & Move::MoveMask);
+    if (m == _best) {
+        return false;
+    }
+
+    if (_best != Move::None && depth >= StableDepth) {
+        ++_changes;
+    }
+    _best = m;
+
+    return true;
+
+}
+
+
+
+/**
+ * Stop the clock and charge the time of the move
+ * The time left gets the increment after the move.
+ * @return time charged in milli seconds
+ */
+long TimeManager::finish (void)
+{
+
+    long                    t = _charged(elapsed());
+
+    _before = _remaining;
+    _pay(t);
+
+    return t;
+
+}
+
+
+
+/**
+ * Correct the time of the last move by the time the server charged
+ * @param t time charged in the unit of the game
+ */
+void TimeManager::charge (long t)
+{
+
+    _remaining = _before;
+    _pay(t * _unit);
+
+}
+
+
+
+/**
+ * Time charged for the milli seconds spent
+ * The delay is not charged, and the rest is rounded to the unit, but is
+ * never less than the least time per move.
+ * @param t time spent
+ * @return time charged
+ */
+long TimeManager::_charged (long t) const
+{
+
+    t = std::max(t - _delay, 0L);
+    t = _roundup ? (t + _unit - 1) / _unit * _unit : t / _unit * _unit;
+
+    return std::max(t, _least);
+
+}
+
+
+
+/**
+ * Charge the time of the move on the time left before it
+ * The time over the time left is paid by the byoyomi.
+ * @param t time charged
+ */
+void TimeManager::_pay (long t)
+{
+
+    _remaining = std::max(_remaining - t, 0L) + _increment;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+// end namespace 'game'
+}
@@ -0,0 +1,294 @@
+/**
+ *****************************************************************************
+
+ @file       TimeManager.h
+
+ @brief      Time manager definitions
+
+ @author     Hiroki Takada (http://wwww.tsoftware.jp/)
+
+ @date       2026-10-18
+
+ @version    $Id:$
+
+
+  Copyright 2014, 2015, 2016, 2017 Hiroki Takada
+
+  This file is part of libshogi.
+
+  libshogi is free software: you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  libshogi is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with libshogi. If not, see <http://www.gnu.org/licenses/>.
+
+
+  ----------------------------------------------------------------------------
+  RELEASE NOTE :
+
+   DATE          REV    REMARK
+  ============= ====== =======================================================
+  18th Oct 2026  0.1   Initial release
+
+ *****************************************************************************/
+
+#ifndef _GAME_TIMEMANAGER_H
+#define _GAME_TIMEMANAGER_H
+
+#include <time.h>
+#include <algorithm>
+
+#include <Common.h>
+
+#include <Move.h>
+#include <CSASummary.h>
+
+// begin namespace 'game'
+namespace game {
+
+/* -------------------------- TimeManager class ---------------------------- */
+
+/**
+ *  Time manager of the game
+ *
+ *  The time control of the game is taken from the CSA game summary, the
+ *  total time, the byoyomi, the increment (Fischer), the delay not
+ *  charged, the least time charged per move, whether the time charged is
+ *  rounded up, and the unit of them. Times are kept in milli seconds and
+ *  measured by CLOCK_MONOTONIC, which the changes of the wall clock do
+ *  not disturb.
+ *
+ *  start() gives the move two limits. The soft limit is the share of the
+ *  time left over the moves expected, plus the increment and the byoyomi;
+ *  the search is not to start a new iteration after it. The hard limit
+ *  is the time the move can take without losing on time, less the margin
+ *  for the network; the search is stopped there in any case. The best
+ *  moves told by update() while searching extend the soft limit each time
+ *  they change, as an unstable best move is worth more time.
+ *
+ *  finish() charges the time of the move as the server does, and
+ *  charge() corrects it by the time the server reported.
+ *
+ */
+class TimeManager
+{
+
+public:
+
+    /// Margin kept for the network in milli seconds
+    static constexpr long   Margin      = 500;
+
+    /// Number of the moves the time left is shared among
+    static constexpr long   MovesToGo   = 40;
+
+    /// Hard limit in the soft limits
+    static constexpr long   HardRatio   = 4;
+
+    /// Extension of the soft limit per change of the best move (percent)
+    static constexpr long   Extension   = 40;
+
+    /// Maximum extension of the soft limit (percent)
+    static constexpr long   MaxExtension = 200;
+
+    /// Minimum depth from which the changes of the best move are counted
+    static constexpr int    StableDepth = 4;
+
+
+
+    /// Constructor (no time control, the limits are unbounded)
+    TimeManager ();
+
+    /// Constructor takes the time control of the game
+    TimeManager (const CSASummary &);
+
+    /// Set the time control of the game
+    void                    set        (const CSASummary &);
+
+    /// Set the time control in milli seconds
+    void                    set        (long, long, long = 0, long = 0,
+                                        long = 0, bool = false, long = 1000);
+
+    /// Start the clock of the move
+    void                    start      (void);
+
+    /// Tell the best move of the search (true if the move changed)
+    bool                    update     (Move::Move, int);
+
+    /// Check if the search is not to start a new iteration
+    bool                    soft       (void)                       const;
+
+    /// Check if the search is to be stopped
+    bool                    hard       (void)                       const;
+
+    /// Stop the clock and charge the time of the move
+    long                    finish     (void);
+
+    /// Correct the time of the last move by the time the server charged
+    void                    charge     (long);
+
+    /// Milli seconds since the clock started
+    long                    elapsed    (void)                       const;
+
+    /// Soft limit of the move in milli seconds
+    long                    softLimit  (void)                       const;
+
+    /// Hard limit of the move in milli seconds
+    long                    hardLimit  (void)                       const;
+
+    /// Time left in milli seconds (without the byoyomi)
+    long                    remaining  (void)                       const;
+
+private:
+
+    /// Time charged for the milli seconds spent
+    long                    _charged   (long)                       const;
+
+    /// Charge the time of the move on the time left before it
+    void                    _pay       (long);
+
+    /// Total time left
+    long                    _remaining;
+
+    /// Byoyomi
+    long                    _byoyomi;
+
+    /// Increment per move
+    long                    _increment;
+
+    /// Delay not charged
+    long                    _delay;
+
+    /// Least time charged per move
+    long                    _least;
+
+    /// Flag rounding the time charged up to the unit
+    bool                    _roundup;
+
+    /// Unit of the time charged
+    long                    _unit;
+
+    /// Flag telling the time is controlled
+    bool                    _control;
+
+    /// Start of the move
+    struct timespec         _start;
+
+    /// Soft limit of the move
+    long                    _soft;
+
+    /// Hard limit of the move
+    long                    _hard;
+
+    /// Number of the changes of the best move
+    int                     _changes;
+
+    /// Best move told last
+    Move::Move              _best;
+
+    /// Time left before the last move
+    long                    _before;
+
+};
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ---------------------------- implementations ---------------------------- */
+
+/**
+ * Milli seconds since the clock started
+ * @return elapsed time
+ */
+inline long TimeManager::elapsed (void) const
+{
+
+    struct timespec         t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (t.tv_sec  - _start.tv_sec ) * 1000 +
+           (t.tv_nsec - _start.tv_nsec) / 1000000;
+
+}
+
+
+
+/**
+ * Soft limit of the move in milli seconds
+ * The limit is extended by the changes of the best move.
+ * @return soft limit
+ */
+inline long TimeManager::softLimit (void) const
+{
+
+    long                    e = std::min(Extension * _changes, MaxExtension);
+
+    return std::min(_soft + _soft * e / 100, _hard);
+
+}
+
+
+
+/**
+ * Hard limit of the move in milli seconds
+ * @return hard limit
+ */
+inline long TimeManager::hardLimit (void) const
+{
+
+    return _hard;
+
+}
+
+
+
+/**
+ * Check if the search is not to start a new iteration
+ * @return true if the soft limit passed
+ */
+inline bool TimeManager::soft (void) const
+{
+
+    return elapsed() >= softLimit();
+
+}
+
+
+
+/**
+ * Check if the search is to be stopped
+ * @return true if the hard limit passed
+ */
+inline bool TimeManager::hard (void) const
+{
+
+    return elapsed() >= _hard;
+
+}
+
+
+
+/**
+ * Time left in milli seconds (without the byoyomi)
+ * @return time left
+ */
+inline long TimeManager::remaining (void) const
+{
+
+    return _remaining;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+// end namespace 'game'
+}
+
+#endif
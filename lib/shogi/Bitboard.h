@@ -150,6 +150,18 @@ public:
     /// Debug function to print the bitboard out
     static void             debug (uint64_t p0, uint64_t p1);
 
+    /// Count 1-bits in each of the bitboards
+    static void             popcnt    (const Bitboard *, size_t, uint32_t *);
+
+    /// LSB of each of the bitboards (Bitope::NoBit if empty)
+    static void             lsb       (const Bitboard *, size_t, uint32_t *);
+
+    /// AND of all the bitboards
+    static Bitboard         intersect (const Bitboard *, size_t);
+
+    /// OR of all the bitboards
+    static Bitboard         merge     (const Bitboard *, size_t);
+
     //
     //
     //
@@ -240,15 +252,113 @@ public:
     /// Bitbord to chose vacant columns
     const Bitboard &        column      (void) const;
 
+    /// Move all the squares by the given delta of squares
+    Bitboard                shift       (Square::Direction) const;
+
     /// Show raw bits in the board
     void                    show        (void);
 
+    /// Iterator over the squares set in the board
+    class iterator;
+
+    /// First square in the board
+    iterator                begin       (void) const;
+
+    /// End of the squares
+    iterator                end         (void) const;
+
     /// Show raw bits in the board
     friend std::ostream &   operator<<  (std::ostream &, const Bitboard &);
 
 }  __attribute__ ((aligned (16)));
 
 
+/**
+ * Iterator over the squares set in the board, which enables
+ *
+ *      for (auto sq : bb) { ... }
+ *
+ * instead of "while (bb) { auto sq = bb.pick(); ... }". It drains p[0]
+ * first and then p[1], so that each step is a tzcnt and a blsr on a single
+ * 64-bit word rather than a test of p[0] and a bsf/btr pair. The board
+ * itself is not modified.
+ */
+class Bitboard::iterator
+{
+
+public:
+
+    /// Constructor takes the both parts of the board
+    iterator (uint64_t p0, uint64_t p1)
+     :  _word(p0 != 0 ? p0 : p1),
+        _next(p0 != 0 ? p1 :  0),
+        _base(p0 != 0 ?  0 : 63) {}
+
+    /// Square at the iterator
+    Square::Square operator* () const
+    {
+        return static_cast<int>(foundation::Bitope::tzcnt(_word)) + _base;
+    }
+
+    /// Advance to the next square
+    iterator & operator++ ()
+    {
+        _word = foundation::Bitope::blsr(_word);
+        if (_word == 0) {
+            _word = _next;
+            _next = 0;
+            _base = 63;
+        }
+        return *this;
+    }
+
+    /// Comparison to the end
+    bool operator!= (const iterator &i) const
+    {
+        return _word != i._word;
+    }
+
+private:
+
+    /// Part of the board being drained
+    uint64_t                _word;
+
+    /// Part of the board to be drained next
+    uint64_t                _next;
+
+    /// Square of bit 0 of _word (bit 63 of p[0] is not used)
+    int                     _base;
+
+};
+
+
+
+/**
+ * First square in the board
+ * @return iterator
+ */
+inline Bitboard::iterator Bitboard::begin (void) const
+{
+
+    return iterator(p[0], p[1]);
+
+}
+
+
+
+/**
+ * End of the squares
+ * @return iterator
+ */
+inline Bitboard::iterator Bitboard::end (void) const
+{
+
+    return iterator(0, 0);
+
+}
+
+
+
 /**
  * Pick a LSB of the board
  * The result won't be predictable if both p[0] and p[1] is zero.
@@ -344,6 +454,100 @@ inline uint64_t Bitboard::part (Square::Square sq) const
 
 }
 
+
+
+/**
+ * Count 1-bits in each of the bitboards at once (Bitope::popcnts)
+ * @parm b array of the bitboards
+ * @parm n number of the bitboards
+ * @parm r array of n results
+ */
+inline void Bitboard::popcnt (const Bitboard *b, size_t n, uint32_t *r)
+{
+
+    foundation::Bitope::popcnts(reinterpret_cast<const uint64_t *>(b), n, r);
+
+}
+
+
+
+/**
+ * Pick a LSB of each of the bitboards at once (Bitope::lsbs)
+ * @parm b array of the bitboards
+ * @parm n number of the bitboards
+ * @parm r array of n squares (Bitope::NoBit if the board is empty)
+ */
+inline void Bitboard::lsb (const Bitboard *b, size_t n, uint32_t *r)
+{
+
+    // bit 63 of p[0] is not used, therefore, bit 0 of p[1] is 63
+    foundation::Bitope::lsbs(reinterpret_cast<const uint64_t *>(b), n, r, 63);
+
+}
+
+
+
+/**
+ * AND of all the bitboards (Bitope::andReduce)
+ * @parm b array of the bitboards
+ * @parm n number of the bitboards
+ * @return intersection (Fill if n is zero)
+ */
+inline Bitboard Bitboard::intersect (const Bitboard *b, size_t n)
+{
+
+    uint64_t                r[2];
+
+    foundation::Bitope::andReduce(reinterpret_cast<const uint64_t *>(b), n, r);
+
+    return Bitboard(r[0], r[1]) & Fill;
+
+}
+
+
+
+/**
+ * OR of all the bitboards (Bitope::orReduce)
+ * @parm b array of the bitboards
+ * @parm n number of the bitboards
+ * @return union
+ */
+inline Bitboard Bitboard::merge (const Bitboard *b, size_t n)
+{
+
+    uint64_t                r[2];
+
+    foundation::Bitope::orReduce(reinterpret_cast<const uint64_t *>(b), n, r);
+
+    return Bitboard(r[0], r[1]);
+
+}
+
+
+
+/**
+ * Move all the squares in the board by the given delta of squares
+ * (Square::UWARD, Square::LWARD and so on). The board is laid out on
+ * an 81-bit line skipping bit 63 of p[0], so that the squares moving
+ * across p[0] and p[1] keep their places. Squares moving out of 0 - 80
+ * are dropped; wrapping around the edge of ranks is up to the caller.
+ * @parm d delta of squares
+ * @return moved board
+ */
+inline Bitboard Bitboard::shift (Square::Direction d) const
+{
+
+    using namespace foundation;
+
+    uint128_t               line = ((uint128_t)p[1] << 63) | p[0];
+
+    line = d > 0 ? line << d : line >> (- d);
+
+    return Bitboard( static_cast<uint64_t>(line      ) & 0x7fffffffffffffffULL,
+                     static_cast<uint64_t>(line >> 63) & 0x000000000003ffffULL);
+
+}
+
 /* ------------------------------------------------------------------------- */
 
 // end namespace 'game'
@@ -39,6 +39,14 @@
  
  *****************************************************************************/ 
 
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+#include <cstdlib>
+#include <cstring>
+
 #include <Piece.h>
 #include <Effect.h>
 #include <Region.h>
@@ -783,6 +791,17 @@ static constexpr Bitboard   RNK1B(0x0040201008040201ULL << 0,
 static constexpr Bitboard   RNK9B(0x0040201008040201ULL << 8,
                                   0x0000000000000201ULL << 8        );
 
+static constexpr Bitboard   RNK2B(0x0040201008040201ULL << 1,
+                                  0x0000000000000201ULL << 1        );
+static constexpr Bitboard   RNK8B(0x0040201008040201ULL << 7,
+                                  0x0000000000000201ULL << 7        );
+
+// squares reachable by one step without wrapping around the ranks
+static constexpr Bitboard   NORNK1(~RNK1B);
+static constexpr Bitboard   NORNK9(~RNK9B);
+static constexpr Bitboard   NORK12(~Bitboard(RNK1B.m | RNK2B.m));
+static constexpr Bitboard   NORK89(~Bitboard(RNK8B.m | RNK9B.m));
+
 // bitboards with a filled column
 static constexpr Bitboard   FIL1B(0x00000000000001ffULL << (9 * 0),
                                   0x0000000000000000ULL             );
@@ -798,22 +817,43 @@ static constexpr Bitboard   FIL9B(0x0000000000000000ULL,
 static Bitboard             _forward[Color::Colors][Square::Ranks];
 
 // KA Effect tables
-static Bitboard             _KAEffectT[20224  + 1];
 static Bitboard             _KAEffectM[Square::Squares];
 static int                  _KAEffectI[Square::Squares];
 
 // HI Effect tables
-static Bitboard             _HIEffectT[495616 + 1];
 static Bitboard             _HIEffectM[Square::Squares];
 static int                  _HIEffectI[Square::Squares];
 
-// KY Effect table (the variation is 2^8)
-static Bitboard             _KYEffectT[Square::Squares][Color::Colors][128];
-static Bitboard             _KBEffectT[Square::Squares][128];
-static Bitboard             _KWEffectT[Square::Squares][128];
-
-// Adjacent Effect table
-static Bitboard             _ADEffectT[Square::Squares][Piece::Pieces];
+// Large effect tables (about 9.3MB) kept in one region so that the whole
+// of them can be backed by huge pages and be replicated per NUMA node
+struct _Tables
+{
+    Bitboard                KAEffectT[20224  + 1];
+    Bitboard                HIEffectT[495616 + 1];
+    // KY Effect table (the variation is 2^8)
+    Bitboard                KYEffectT[Square::Squares][Color::Colors][128];
+    Bitboard                KBEffectT[Square::Squares][128];
+    Bitboard                KWEffectT[Square::Squares][128];
+    // Adjacent Effect table
+    Bitboard                ADEffectT[Square::Squares][Piece::Pieces];
+};
+
+#ifdef USE_HUGEPAGEEFFECTTABLE
+// Master tables and replicas on each NUMA node
+static _Tables *            _master = nullptr;
+static _Tables *            _replica[Nodes];
+static bool                 _advised = false;
+// Lock for making the replicas (published by a release store)
+static pthread_mutex_t      _replicating = PTHREAD_MUTEX_INITIALIZER;
+// Tables the calling thread refers to (nullptr means the master)
+static thread_local _Tables *
+                            _local __attribute__ ((tls_model ("initial-exec")))
+                                   = nullptr;
+#define _TABLES             (*(_local != nullptr ? _local : _master))
+#else
+static _Tables              _tables;
+#define _TABLES             _tables
+#endif
 
 // Direction mask for escaping from distant effect
 static Bitboard             _direction[Square::Squares][Direction::Directions];
@@ -828,6 +868,9 @@ static void     _initHIEffect    (void);
 static void     _initKYEffect    (void);
 static void     _initADEffect    (void);
 static void     _initDirection   (void);
+#ifdef USE_HUGEPAGEEFFECTTABLE
+static _Tables *_allocTables     (int);
+#endif
 
 static Bitboard _indexToOccupied (int, int, Bitboard);
 static Bitboard _KAEffectCalc    (Square::Square, const Bitboard &);
@@ -837,6 +880,11 @@ static Bitboard _HIEffectMask    (Square::Square);
 static Bitboard _KEEffectCalc    (Color::Color, Square::Square);
 static Bitboard _KIEffectCalc    (Color::Color, Square::Square);
 
+static Bitboard _bulkStep        (const Bitboard &, Square::Direction,
+                                                    const Bitboard &);
+static Bitboard _bulkFill        (Bitboard, Bitboard, Square::Direction,
+                                                    const Bitboard &);
+
 /* ------------------------------------------------------------------------- */
 
 
@@ -893,7 +941,7 @@ static void _initForward (void)
 static void _initKAEffect (void)
 {
 
-    Bitboard *              effect = _KAEffectT;
+    Bitboard *              effect = _TABLES.KAEffectT;
     Bitboard *              mask   = _KAEffectM;
     int *                   eindex = _KAEffectI;
 
@@ -934,7 +982,7 @@ static void _initKAEffect (void)
 static void _initHIEffect (void)
 {
 
-    Bitboard *              effect = _HIEffectT;
+    Bitboard *              effect = _TABLES.HIEffectT;
     Bitboard *              mask   = _HIEffectM;
     int *                   eindex = _HIEffectI;
 
@@ -975,6 +1023,9 @@ static void _initHIEffect (void)
 static void _initKYEffect (void)
 {
 
+    auto &                  ky  = _TABLES.KYEffectT;
+    auto &                  kb  = _TABLES.KBEffectT;
+    auto &                  kw  = _TABLES.KWEffectT;
     const int               var = 7; // variation of the occupation
 
     for (auto c : Color::all) {
@@ -982,12 +1033,12 @@ static void _initKYEffect (void)
             Bitboard mask = Bitboard::File[Square::toFile(sq)] & (~(RNK1B | RNK9B));
             for (int i = 0; i < (1 << var); ++i) {
                 Bitboard occupied    = _indexToOccupied(i, var, mask);
-                _KYEffectT[sq][c][i] = HI(sq, occupied)
+                ky[sq][c][i]         = HI(sq, occupied)
                                         & _forward[c][Square::toRank(sq)];
                 if (c == Color::Black) {
-                    _KBEffectT[sq][i] = _KYEffectT[sq][c][i];
+                    kb[sq][i] = ky[sq][c][i];
                 } else {
-                    _KWEffectT[sq][i] = _KYEffectT[sq][c][i];
+                    kw[sq][i] = ky[sq][c][i];
                 }
                     
             }
@@ -1006,44 +1057,46 @@ static void _initADEffect (void)
 
     using namespace Piece;
 
+    auto &                  effect = _TABLES.ADEffectT;
+
     for (auto c : Color::all) {
         for (auto sq : Square::all) {
 
             // FU
-            _ADEffectT[sq][polar(Piece::FU, c)] = KY(c, sq, Bitboard::Fill);
+            effect[sq][polar(Piece::FU, c)] = KY(c, sq, Bitboard::Fill);
 
             // KY has none of adjacent effect but long-distance effect
-            _ADEffectT[sq][polar(Piece::KY, c)] = Bitboard::Zero;
+            effect[sq][polar(Piece::KY, c)] = Bitboard::Zero;
 
             // KE 
-            _ADEffectT[sq][polar(Piece::KE, c)] = _KEEffectCalc(c, sq);
+            effect[sq][polar(Piece::KE, c)] = _KEEffectCalc(c, sq);
 
             // GI
-            _ADEffectT[sq][polar(Piece::GI, c)] = KY(c, sq, Bitboard::Fill) |
-                                                  KA(   sq, Bitboard::Fill)   ;
+            effect[sq][polar(Piece::GI, c)] = KY(c, sq, Bitboard::Fill) |
+                                              KA(   sq, Bitboard::Fill)   ;
 
             // KI, TO, NY, NK, NG
-            _ADEffectT[sq][polar(Piece::KI, c)] = _KIEffectCalc(c, sq);
-            _ADEffectT[sq][polar(Piece::TO, c)] = _KIEffectCalc(c, sq);
-            _ADEffectT[sq][polar(Piece::NY, c)] = _KIEffectCalc(c, sq);
-            _ADEffectT[sq][polar(Piece::NK, c)] = _KIEffectCalc(c, sq);
-            _ADEffectT[sq][polar(Piece::NG, c)] = _KIEffectCalc(c, sq);
+            effect[sq][polar(Piece::KI, c)] = _KIEffectCalc(c, sq);
+            effect[sq][polar(Piece::TO, c)] = _KIEffectCalc(c, sq);
+            effect[sq][polar(Piece::NY, c)] = _KIEffectCalc(c, sq);
+            effect[sq][polar(Piece::NK, c)] = _KIEffectCalc(c, sq);
+            effect[sq][polar(Piece::NG, c)] = _KIEffectCalc(c, sq);
 
             // KA has none of adjacent effect but long-distance effect
-            _ADEffectT[sq][polar(Piece::KA, c)] = Bitboard::Zero;
+            effect[sq][polar(Piece::KA, c)] = Bitboard::Zero;
 
             // HI has none of adjacent effect but long-distance effect
-            _ADEffectT[sq][polar(Piece::HI, c)] = Bitboard::Zero;
+            effect[sq][polar(Piece::HI, c)] = Bitboard::Zero;
 
             // OU
-            _ADEffectT[sq][polar(Piece::OU, c)] = HI(sq, Bitboard::Fill) |
-                                                  KA(sq, Bitboard::Fill)   ;
+            effect[sq][polar(Piece::OU, c)] = HI(sq, Bitboard::Fill) |
+                                              KA(sq, Bitboard::Fill)   ;
 
             // UM
-            _ADEffectT[sq][polar(Piece::UM, c)] = HI(sq, Bitboard::Fill);
+            effect[sq][polar(Piece::UM, c)] = HI(sq, Bitboard::Fill);
 
             // RY
-            _ADEffectT[sq][polar(Piece::RY, c)] = KA(sq, Bitboard::Fill);
+            effect[sq][polar(Piece::RY, c)] = KA(sq, Bitboard::Fill);
         }
     }
 
@@ -1232,6 +1285,69 @@ static Bitboard _HIEffectMask (Square::Square sq)
 
 
 
+#ifdef USE_HUGEPAGEEFFECTTABLE
+/**
+ * Allocate a region for the effect tables backed by huge pages.
+ * The region is aligned to the huge page boundary and advised with
+ * MADV_HUGEPAGE. When a NUMA node is given, the region prefers that node.
+ * Either of the advices may be refused by the kernel, in which case the
+ * tables simply live in ordinary pages (or on the node which touches them
+ * first), so that neither failure is fatal.
+ * @param node NUMA node to be preferred (-1 for no preference)
+ * @return allocated tables
+ */
+static _Tables * _allocTables (int node)
+{
+
+    const size_t            page = HugePage;
+    const size_t            size = (sizeof(_Tables) + page - 1) & ~(page - 1);
+
+    // map one extra huge page to align the region to the page boundary
+    void *                  area = mmap(nullptr, size + page,
+                                        PROT_READ | PROT_WRITE,
+                                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    // fall back on the heap when the kernel refuses the mapping
+    if (area == MAP_FAILED) {
+        _GAME_EFFECT_DEBUG_FUNCTION_RESULT("mmap()");
+        void *              heap;
+        if (posix_memalign(&heap, 64, sizeof(_Tables)) != 0) {
+            throw EffectException();
+        }
+        return static_cast<_Tables *>(heap);
+    }
+
+    // trim the both ends of the mapping
+    uintptr_t               head = reinterpret_cast<uintptr_t>(area);
+    uintptr_t               base = (head + page - 1) & ~(page - 1);
+    if (base > head) {
+        munmap(area, base - head);
+    }
+    munmap(reinterpret_cast<void *>(base + size), page - (base - head));
+    void *                  addr = reinterpret_cast<void *>(base);
+
+    // transparent huge pages
+    if (madvise(addr, size, MADV_HUGEPAGE) == 0) {
+        _advised = true;
+    } else {
+        _GAME_EFFECT_DEBUG_FUNCTION_RESULT("madvise()");
+    }
+
+    // place the pages on the node before they are touched
+    if (node >= 0) {
+        unsigned long       mask = 1UL << node;
+        if (syscall(SYS_mbind, addr, size, MPOL_PREFERRED,
+                                    &mask, sizeof(mask) * 8, 0) != 0) {
+            _GAME_EFFECT_DEBUG_FUNCTION_RESULT("mbind()");
+        }
+    }
+
+    return static_cast<_Tables *>(addr);
+
+}
+#endif
+
+
 /**
  * Calculate KE effect
  * @param c color of piece
@@ -1314,6 +1430,49 @@ static Bitboard _KIEffectCalc (Color::Color c, Square::Square sq)
 
 
 
+/**
+ * One step of all the pieces in the board
+ * @param from squares of the pieces
+ * @param d direction of the step
+ * @param mask squares reachable by the step without wrapping
+ * @return squares stepped to
+ */
+static inline Bitboard _bulkStep (const Bitboard &from, Square::Direction d,
+                                                    const Bitboard &mask)
+{
+
+    return from.shift(d) & mask;
+
+}
+
+
+
+/**
+ * Occluded fill (Kogge-Stone) of all the sliding pieces in the board.
+ * The ray of 8 squares at most is filled by the steps of 1, 2 and 4, and
+ * the final step gives the effect including the blocking squares.
+ * @param from squares of the pieces
+ * @param vacant squares the effect passes through
+ * @param d direction of the ray
+ * @param mask squares reachable by one step without wrapping
+ * @return squares on the rays
+ */
+static inline Bitboard _bulkFill (Bitboard from, Bitboard vacant,
+                                  Square::Direction d, const Bitboard &mask)
+{
+
+    vacant &= mask;
+    from   |= vacant & from.shift(d);
+    vacant &= vacant.shift(d);
+    from   |= vacant & from.shift(d * 2);
+    vacant &= vacant.shift(d * 2);
+    from   |= vacant & from.shift(d * 4);
+
+    return from.shift(d) & mask;
+
+}
+
+
 /**
  * HI effect
  * @param sq square of the piece
@@ -1327,7 +1486,7 @@ const Bitboard & HI (Square::Square sq, const Bitboard &ocp)
 
     index = _HIEffectI[sq] + ocp.index(_HIEffectM[sq]);
 
-    return _HIEffectT[index];
+    return _TABLES.HIEffectT[index];
 
 }
 
@@ -1346,7 +1505,7 @@ const Bitboard & KA (Square::Square sq, const Bitboard &ocp)
 
     index = _KAEffectI[sq] + ocp.index(_KAEffectM[sq]);
 
-    return _KAEffectT[index];
+    return _TABLES.KAEffectT[index];
 
 }
 
@@ -1366,7 +1525,7 @@ const Bitboard & KY (Color::Color c, Square::Square sq, const Bitboard &ocp)
 
     index = (ocp.part(sq) >> Bitboard::VShift[sq]) & 0x7f;
 
-    return _KYEffectT[sq][c][index];
+    return _TABLES.KYEffectT[sq][c][index];
 
 }
 
@@ -1385,7 +1544,7 @@ const Bitboard & KB (Square::Square sq, const Bitboard &ocp)
 
     index = (ocp.part(sq) >> Bitboard::VShift[sq]) & 0x7f;
 
-    return _KBEffectT[sq][index];
+    return _TABLES.KBEffectT[sq][index];
 
 }
 
@@ -1404,7 +1563,7 @@ const Bitboard & KW (Square::Square sq, const Bitboard &ocp)
 
     index = (ocp.part(sq) >> Bitboard::VShift[sq]) & 0x7f;
 
-    return _KWEffectT[sq][index];
+    return _TABLES.KWEffectT[sq][index];
 
 }
 
@@ -1419,7 +1578,7 @@ const Bitboard & KW (Square::Square sq, const Bitboard &ocp)
 const Bitboard & AD (Square::Square sq, Piece::Piece p)
 {
 
-    return _ADEffectT[sq][p];
+    return _TABLES.ADEffectT[sq][p];
 
 }
 
@@ -1433,7 +1592,7 @@ const Bitboard & AD (Square::Square sq, Piece::Piece p)
 const Bitboard & FK (Square::Square sq)
 {
 
-    return _ADEffectT[sq][Piece::BKA];
+    return _TABLES.ADEffectT[sq][Piece::BKA];
 
 }
 
@@ -1503,7 +1662,7 @@ const Bitboard & HV (Square::Square sq)
 const Bitboard & FH (Square::Square sq)
 {
 
-    return _ADEffectT[sq][Piece::BHI];
+    return _TABLES.ADEffectT[sq][Piece::BHI];
 
 }
 
@@ -1566,6 +1725,214 @@ const Bitboard & LD (Square::Square sq)
 
 
 
+/**
+ * Union of effects of all the pieces of one kind. The cost does not depend
+ * on the number of pieces; the steps are shifts of the whole board and the
+ * rays of KY, KA and HI are given by occluded fills.
+ * @param pc piece with polarity
+ * @param from squares of the pieces (e.g. Position::bitboard(pc))
+ * @param ocp occupation
+ * @return effect in bitboard
+ */
+Bitboard bulk (Piece::Piece pc, const Bitboard &from, const Bitboard &ocp)
+{
+
+    using namespace Square;
+
+    const bool              black  = (Piece::color(pc) == Color::Black);
+    const Piece::Piece      kind   = pc & (~Piece::Color);
+
+    // forward and backward for the color
+    const Square::Direction fw     = black ? UWARD  : DWARD;
+    const Square::Direction bw     = black ? DWARD  : UWARD;
+    const Bitboard &        fwmask = black ? NORNK9 : NORNK1;
+    const Bitboard &        bwmask = black ? NORNK1 : NORNK9;
+
+    Bitboard                result;
+
+    switch (kind) {
+
+    case Piece::FU:
+        result  = _bulkStep(from, fw, fwmask);
+        break;
+
+    case Piece::KY:
+        result  = _bulkFill(from, ~ocp, fw, fwmask);
+        break;
+
+    case Piece::KE:
+        result  = _bulkStep(from, fw * 2 + RWARD, black ? NORK89 : NORK12);
+        result |= _bulkStep(from, fw * 2 + LWARD, black ? NORK89 : NORK12);
+        break;
+
+    case Piece::GI:
+        result  = _bulkStep(from, fw,         fwmask);
+        result |= _bulkStep(from, fw + RWARD, fwmask);
+        result |= _bulkStep(from, fw + LWARD, fwmask);
+        result |= _bulkStep(from, bw + RWARD, bwmask);
+        result |= _bulkStep(from, bw + LWARD, bwmask);
+        break;
+
+    case Piece::KI:
+    case Piece::TO:
+    case Piece::NY:
+    case Piece::NK:
+    case Piece::NG:
+        result  = _bulkStep(from, fw,         fwmask);
+        result |= _bulkStep(from, fw + RWARD, fwmask);
+        result |= _bulkStep(from, fw + LWARD, fwmask);
+        result |= _bulkStep(from, RWARD,      Bitboard::Fill);
+        result |= _bulkStep(from, LWARD,      Bitboard::Fill);
+        result |= _bulkStep(from, bw,         bwmask);
+        break;
+
+    case Piece::OU:
+        result  = _bulkStep(from, UWARD,      NORNK9);
+        result |= _bulkStep(from, UWRDR,      NORNK9);
+        result |= _bulkStep(from, UWRDL,      NORNK9);
+        result |= _bulkStep(from, RWARD,      Bitboard::Fill);
+        result |= _bulkStep(from, LWARD,      Bitboard::Fill);
+        result |= _bulkStep(from, DWARD,      NORNK1);
+        result |= _bulkStep(from, DWRDR,      NORNK1);
+        result |= _bulkStep(from, DWRDL,      NORNK1);
+        break;
+
+    case Piece::KA:
+    case Piece::UM:
+        result  = _bulkFill(from, ~ocp, UWRDR, NORNK9);
+        result |= _bulkFill(from, ~ocp, UWRDL, NORNK9);
+        result |= _bulkFill(from, ~ocp, DWRDR, NORNK1);
+        result |= _bulkFill(from, ~ocp, DWRDL, NORNK1);
+        if (kind == Piece::UM) {
+            result |= _bulkStep(from, UWARD,  NORNK9);
+            result |= _bulkStep(from, RWARD,  Bitboard::Fill);
+            result |= _bulkStep(from, LWARD,  Bitboard::Fill);
+            result |= _bulkStep(from, DWARD,  NORNK1);
+        }
+        break;
+
+    case Piece::HI:
+    case Piece::RY:
+        result  = _bulkFill(from, ~ocp, UWARD, NORNK9);
+        result |= _bulkFill(from, ~ocp, DWARD, NORNK1);
+        result |= _bulkFill(from, ~ocp, RWARD, Bitboard::Fill);
+        result |= _bulkFill(from, ~ocp, LWARD, Bitboard::Fill);
+        if (kind == Piece::RY) {
+            result |= _bulkStep(from, UWRDR,  NORNK9);
+            result |= _bulkStep(from, UWRDL,  NORNK9);
+            result |= _bulkStep(from, DWRDR,  NORNK1);
+            result |= _bulkStep(from, DWRDL,  NORNK1);
+        }
+        break;
+
+    default:
+        break;
+
+    }
+
+    return result;
+
+}
+
+
+/**
+ * Make a replica of the effect tables on the NUMA node. The calling thread
+ * copies the master tables, so the pages stay on its own node even if the
+ * kernel does not accept the memory policy. Calling this for the node
+ * already replicated does nothing. The threads may call this at once; only
+ * one of them makes the replica, and it is published after the copy.
+ * @param node NUMA node (0 to Nodes - 1)
+ * @return true if the replica is available
+ */
+bool replicate (int node)
+{
+
+#ifdef USE_HUGEPAGEEFFECTTABLE
+    if (node < 0 || node >= Nodes || _master == nullptr) {
+        return false;
+    }
+
+    if (__atomic_load_n(&_replica[node], __ATOMIC_ACQUIRE) != nullptr) {
+        return true;
+    }
+
+    pthread_mutex_lock(&_replicating);
+    if (__atomic_load_n(&_replica[node], __ATOMIC_RELAXED) == nullptr) {
+        _Tables *           tables;
+        try {
+            tables = _allocTables(node);
+        } catch (...) {
+            pthread_mutex_unlock(&_replicating);
+            throw;
+        }
+        memcpy(static_cast<void *>(tables), _master, sizeof(_Tables));
+        __atomic_store_n(&_replica[node], tables, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&_replicating);
+
+    return true;
+#else
+    (void)node;
+    return false;
+#endif
+
+}
+
+
+
+/**
+ * Let the calling thread refer to the replica on the NUMA node.
+ * A negative node turns the thread back to the master tables.
+ * @param node NUMA node (0 to Nodes - 1, or -1)
+ * @return true if the thread refers to the requested tables
+ */
+bool attach (int node)
+{
+
+#ifdef USE_HUGEPAGEEFFECTTABLE
+    if (node < 0) {
+        _local = nullptr;
+        return true;
+    }
+
+    if (node >= Nodes) {
+        return false;
+    }
+
+    _Tables *               tables = __atomic_load_n(&_replica[node],
+                                                     __ATOMIC_ACQUIRE);
+    if (tables == nullptr) {
+        return false;
+    }
+
+    _local = tables;
+
+    return true;
+#else
+    return node < 0;
+#endif
+
+}
+
+
+
+/**
+ * Whether the effect tables are advised to be backed by huge pages
+ * @return true if madvise(MADV_HUGEPAGE) was accepted
+ */
+bool hugepage (void)
+{
+
+#ifdef USE_HUGEPAGEEFFECTTABLE
+    return _advised;
+#else
+    return false;
+#endif
+
+}
+
+
+
 /**
  * Initializer
  * 
@@ -1573,6 +1940,13 @@ const Bitboard & LD (Square::Square sq)
 void initialize ()
 {
 
+#ifdef USE_HUGEPAGEEFFECTTABLE
+    // region for the large tables
+    if (_master == nullptr) {
+        _master = _allocTables(-1);
+    }
+#endif
+
     // initialize _forward
     _initForward();
 
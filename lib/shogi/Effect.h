@@ -76,12 +76,32 @@ namespace game { namespace Effect {
 /**
  * The functions and tables concerning the effects. 
  * Apery and YaneuraOu gave me great idea to implement this.
+ * Building with HUGEPAGE=y places the large tables in a region backed by
+ * huge pages, and lets threads refer to replicas on their NUMA nodes.
  * 
  */
 
+/// Exception
+class EffectException {};
+
+/// Size of a huge page
+constexpr size_t        HugePage   = 2 * 1024 * 1024;
+
+/// Maximum number of NUMA nodes holding replicas of the tables
+constexpr int           Nodes      = 8;
+
 /// Initialize
 void                    initialize (void);
 
+/// Make a replica of the tables on a NUMA node
+bool                    replicate  (int);
+
+/// Let the calling thread refer to the replica on a NUMA node
+bool                    attach     (int);
+
+/// Whether the tables are advised to be backed by huge pages
+bool                    hugepage   (void);
+
 /// KA effect
 const Bitboard &        KA         (Square::Square, const Bitboard &);
 
@@ -131,6 +151,10 @@ const Bitboard &        OC         (Square::Square);
 /// Masking bitboard distant squares for octant directions
 const Bitboard &        LD         (Square::Square);
 
+/// Union of effects of all the pieces of one kind
+Bitboard                bulk       (Piece::Piece, const Bitboard &,
+                                                   const Bitboard &);
+
 /* ------------------------------------------------------------------------- */
 
 // end namespace 'game::Effect'
@@ -0,0 +1,347 @@
+/**
+ *****************************************************************************
+
+ @file       EvalCache.h
+
+ @brief      Cache of the evaluations keyed by the hash key
+  
+ @author     Hiroki Takada (http://wwww.tsoftware.jp/)
+
+ @date       2026-10-18
+
+ @version    $Id:$
+
+
+  Copyright 2014, 2015, 2016, 2017 Hiroki Takada
+
+  This file is part of libshogi.
+
+  libshogi is free software: you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  libshogi is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with libshogi. If not, see <http://www.gnu.org/licenses/>.
+
+   
+  ----------------------------------------------------------------------------
+  RELEASE NOTE :
+
+   DATE          REV    REMARK
+  ============= ====== =======================================================
+  18th Oct 2026  0.1   Initial release
+ 
+ *****************************************************************************/ 
+
+#ifndef _GAME_EVALCACHE_H
+#define _GAME_EVALCACHE_H
+
+#include <cstring>
+#include <type_traits>
+
+#include <Common.h>
+
+#include <Zobrist.h>
+#include <Evaluation.h>
+
+// begin namespace 'game'
+namespace game {
+
+/* ------------------------- eval cache exceptions ------------------------- */
+class EvalCacheException {};
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ---------------------------- EvalCache class ---------------------------- */
+
+/**
+ *  Cache of the evaluations keyed by the hash key
+ *
+ *  A direct mapped table of the values up to 32 bits, such as Eval or a
+ *  pair of 16-bit terms. The low bits of the key choose the entry, which
+ *  keeps the entries apart from the transposition table choosing the
+ *  clusters by the high bits of the same key. A subclass of Position
+ *  typically looks up hash() in its eval() override, or hashPawn() and
+ *  hashKing() for the terms of the FU structure and the king safety.
+ *
+ *  The cache is meant to be owned by each search thread, as it is small
+ *  enough to stay in the private cache of the core. It is still safe to
+ *  share one; the entry is a pair of the data and the key XORed with the
+ *  data as in TranspositionTable, and a torn entry is just a miss. The
+ *  counters of the probes and the hits are not exact on a shared cache.
+ *
+ */
+template <typename T = Evaluation::Eval>
+class EvalCache
+{
+
+    static_assert(sizeof(T) <= sizeof(uint32_t) &&
+                  std::is_trivially_copyable<T>::value,
+                  "EvalCache holds trivially copyable values up to 32 bits");
+
+public:
+
+    /// Default size of the cache in KiB
+    static constexpr size_t Default     = 1024;
+
+    /// Constructor takes the size in KiB
+    EvalCache (size_t = Default);
+
+    /// Destructor
+    ~EvalCache ();
+
+    /// Clear all the entries and the counters
+    void                    clear      (void);
+
+    /// Store the value
+    void                    store      (Zobrist::key, const T &);
+
+    /// Look up the value
+    bool                    probe      (Zobrist::key, T &);
+
+    /// Number of entries
+    size_t                  size       (void)                         const;
+
+    /// Number of the probes
+    uint64_t                probes     (void)                         const;
+
+    /// Number of the hits
+    uint64_t                hits       (void)                         const;
+
+    /// Permille of the probes hit
+    int                     hitrate    (void)                         const;
+
+private:
+
+    /// Entry
+    struct Entry {
+        uint64_t            check;
+        uint64_t            data;
+    };
+
+    /// Flag of the data word telling the entry is used
+    static constexpr uint64_t Valid     = 1ULL << 63;
+
+    /// Count up the counter
+    static void             _count     (uint64_t &);
+
+    /// void copy constructor
+    EvalCache (const EvalCache<T> &);
+
+    /// void copy
+    EvalCache<T> &          operator=  (const EvalCache<T> &);
+
+    /// Entries
+    Entry *                 _table;
+
+    /// Mask of the key choosing the entry
+    size_t                  _mask;
+
+    /// Number of the probes
+    uint64_t                _probes;
+
+    /// Number of the hits
+    uint64_t                _hits;
+
+};
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ---------------------------- implementations ---------------------------- */
+
+/**
+ * Constructor
+ * The number of entries is rounded down to a power of two.
+ * @param kib size of the cache in KiB
+ */
+template <typename T>
+EvalCache<T>::EvalCache (size_t kib)
+ : _table(nullptr), _mask(0), _probes(0), _hits(0)
+{
+
+    size_t                  n = (kib << 10) / sizeof(Entry);
+    if (n == 0) {
+        throw EvalCacheException();
+    }
+    while (n & (n - 1)) {
+        n &= n - 1;
+    }
+
+    _table = new Entry[n];
+    _mask  = n - 1;
+    clear();
+
+}
+
+
+
+/**
+ * Destructor
+ * 
+ */
+template <typename T>
+EvalCache<T>::~EvalCache ()
+{
+
+    delete [] _table;
+
+}
+
+
+
+/**
+ * Clear all the entries and the counters
+ * 
+ */
+template <typename T>
+void EvalCache<T>::clear (void)
+{
+
+    memset(static_cast<void *>(_table), 0, size() * sizeof(Entry));
+    _probes = 0;
+    _hits   = 0;
+
+}
+
+
+
+/**
+ * Store the value
+ * The entry of another position is simply overwritten.
+ * @param k hash key
+ * @param v value
+ */
+template <typename T>
+inline void EvalCache<T>::store (Zobrist::key k, const T &v)
+{
+
+    uint32_t                bits = 0;
+    memcpy(&bits, &v, sizeof(T));
+
+    Entry *                 e    = _table + (k & _mask);
+    uint64_t                d    = Valid | bits;
+
+    __atomic_store_n(&e->check, k ^ d, __ATOMIC_RELAXED);
+    __atomic_store_n(&e->data ,     d, __ATOMIC_RELAXED);
+
+}
+
+
+
+/**
+ * Look up the value
+ * @param k hash key
+ * @param v value to be filled when found
+ * @return true if found
+ */
+template <typename T>
+inline bool EvalCache<T>::probe (Zobrist::key k, T &v)
+{
+
+    const Entry *           e = _table + (k & _mask);
+    uint64_t                c = __atomic_load_n(&e->check, __ATOMIC_RELAXED);
+    uint64_t                d = __atomic_load_n(&e->data , __ATOMIC_RELAXED);
+
+    _count(_probes);
+    if ((c ^ d) != k || ! (d & Valid)) {
+        return false;
+    }
+    _count(_hits);
+
+    uint32_t                bits = static_cast<uint32_t>(d);
+    memcpy(&v, &bits, sizeof(T));
+
+    return true;
+
+}
+
+
+
+/**
+ * Count up the counter
+ * The increment is not atomic; a few counts may be lost when the cache
+ * is shared, but no lock is taken on the hot path.
+ * @param n counter
+ */
+template <typename T>
+inline void EvalCache<T>::_count (uint64_t &n)
+{
+
+    __atomic_store_n(&n, __atomic_load_n(&n, __ATOMIC_RELAXED) + 1,
+                     __ATOMIC_RELAXED);
+
+}
+
+
+
+/**
+ * Number of entries
+ * @return number of entries
+ */
+template <typename T>
+inline size_t EvalCache<T>::size (void) const
+{
+
+    return _mask + 1;
+
+}
+
+
+
+/**
+ * Number of the probes
+ * @return number of the probes since cleared
+ */
+template <typename T>
+inline uint64_t EvalCache<T>::probes (void) const
+{
+
+    return __atomic_load_n(&_probes, __ATOMIC_RELAXED);
+
+}
+
+
+
+/**
+ * Number of the hits
+ * @return number of the hits since cleared
+ */
+template <typename T>
+inline uint64_t EvalCache<T>::hits (void) const
+{
+
+    return __atomic_load_n(&_hits, __ATOMIC_RELAXED);
+
+}
+
+
+
+/**
+ * Permille of the probes hit
+ * @return permille of the hits (0 before any probe)
+ */
+template <typename T>
+int EvalCache<T>::hitrate (void) const
+{
+
+    uint64_t                n = probes();
+
+    return n == 0 ? 0 : static_cast<int>(hits() * 1000 / n);
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+// end namespace 'game'
+}
+
+#endif
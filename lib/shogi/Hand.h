@@ -0,0 +1,164 @@
+/**
+ *****************************************************************************
+
+ @file       Hand.h
+
+ @brief      Definitions for packed hands
+  
+ @author     Hiroki Takada (http://wwww.tsoftware.jp/)
+
+ @date       2026-10-18
+
+ @version    $Id:$
+
+
+  Copyright 2014, 2015, 2016, 2017 Hiroki Takada
+
+  This file is part of libshogi.
+
+  libshogi is free software: you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  libshogi is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with libshogi. If not, see <http://www.gnu.org/licenses/>.
+
+   
+  ----------------------------------------------------------------------------
+  RELEASE NOTE :
+
+   DATE          REV    REMARK
+  ============= ====== =======================================================
+  18th Oct 2026  0.1   Initial release
+ 
+ *****************************************************************************/ 
+
+#ifndef _GAME_HAND_H
+#define _GAME_HAND_H
+
+#include <Common.h>
+#include <Piece.h>
+
+// begin namespace 'game::Hand'
+namespace game { namespace Hand {
+
+/* ------------------------------ definitions ------------------------------ */
+
+/**
+ *  Hand
+ *   is the pieces in the hand of a player packed in 32 bits;
+ *
+ *   MSB                                                         LSB
+ *   31  28 27 26 24 23 22 21 20 19 18 17 16 14 13 12 10  9  8  6  5  4    0
+ *  +------+--+-----+--+-----+--+-----+--+-----+--+-----+--+-----+--+------+
+ *  |      |g |  KI |g |  HI |g |  KA |g |  GI |g |  KE |g |  KY |g |  FU  |
+ *  +------+--+-----+--+-----+--+-----+--+-----+--+-----+--+-----+--+------+
+ *
+ *   Each number has a guard bit (g) above it, which catches the borrow
+ *   when the hands are subtracted. A hand holds every kind of pieces as
+ *   many as another does if the subtraction never borrows. Mate search
+ *   uses this to prove a position by another on the same board with the
+ *   inferior (or superior) hand.
+ *
+ */
+using Hand = uint32_t;
+
+/// Shift of the number of each piece
+static const int            Shift[Piece::Kind] = {
+                            //  EMP   FU   KY   KE   GI   KA   HI   KI
+                                  0,   0,   6,  10,  14,  18,  21,  24
+                            };
+
+/// Width of the number of each piece (without the guard bit)
+static const int            Width[Piece::Kind] = {
+                            //  EMP   FU   KY   KE   GI   KA   HI   KI
+                                  0,   5,   3,   3,   3,   2,   2,   3
+                            };
+
+/// Guard bits
+static const Hand           Borrow  = (1U <<  5) | (1U <<  9) | (1U << 13) |
+                                      (1U << 17) | (1U << 20) | (1U << 23) |
+                                      (1U << 27);
+
+/// Empty hand
+static const Hand           Empty   = 0;
+
+
+
+/**
+ * Pack the numbers of the pieces in the hand
+ * @param n numbers of the pieces indexed by Piece::FU .. Piece::KI
+ * @return packed hand
+ */
+inline Hand pack (const int (&n)[Piece::Kind])
+{
+
+    Hand                    h = Empty;
+
+    for (auto p : Piece::hand) {
+        h += static_cast<Hand>(n[p]) << Shift[p];
+    }
+
+    return h;
+
+}
+
+
+
+/**
+ * Number of the piece in the hand
+ * @param h packed hand
+ * @param p piece (Piece::FU .. Piece::KI)
+ * @return number of the pieces
+ */
+inline int count (Hand h, Piece::Piece p)
+{
+
+    return static_cast<int>((h >> Shift[p]) & ((1U << Width[p]) - 1));
+
+}
+
+
+
+/**
+ * Check if the hand holds every kind of the pieces at least as many as
+ * the other one
+ * @param h hand
+ * @param o other hand
+ * @return true if h is superior to (or equal with) o
+ */
+inline bool superior (Hand h, Hand o)
+{
+
+    return ((h - o) & Borrow) == 0;
+
+}
+
+
+
+/**
+ * Check if the other hand holds every kind of the pieces at least as many
+ * as the hand
+ * @param h hand
+ * @param o other hand
+ * @return true if h is inferior to (or equal with) o
+ */
+inline bool inferior (Hand h, Hand o)
+{
+
+    return ((o - h) & Borrow) == 0;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+// end namespace 'game::Hand'
+} }
+
+#endif
@@ -0,0 +1,351 @@
+/**
+ *****************************************************************************
+
+ @file       HandTable.h
+
+ @brief      Hash table looking up the positions by the board and the hand
+  
+ @author     Hiroki Takada (http://wwww.tsoftware.jp/)
+
+ @date       2026-10-18
+
+ @version    $Id:$
+
+
+  Copyright 2014, 2015, 2016, 2017 Hiroki Takada
+
+  This file is part of libshogi.
+
+  libshogi is free software: you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  libshogi is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with libshogi. If not, see <http://www.gnu.org/licenses/>.
+
+   
+  ----------------------------------------------------------------------------
+  RELEASE NOTE :
+
+   DATE          REV    REMARK
+  ============= ====== =======================================================
+  18th Oct 2026  0.1   Initial release
+ 
+ *****************************************************************************/ 
+
+#ifndef _GAME_HANDTABLE_H
+#define _GAME_HANDTABLE_H
+
+#include <Common.h>
+
+#include <Zobrist.h>
+#include <Hand.h>
+
+// begin namespace 'game'
+namespace game {
+
+/* ------------------------- hand table exceptions ------------------------- */
+class HandTableException {};
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ---------------------------- HandTable class ---------------------------- */
+
+/**
+ *  Hash table indexed by the board
+ *
+ *  The entries of the positions on the same board share a bucket chosen
+ *  by the board key (Position::hashBoard()), and are told apart by the
+ *  packed hand (Position::hand()). Besides the exact look up, the table
+ *  finds an entry whose hand is superior or inferior to the given one.
+ *  In mate search, a position is mate if the same board with an inferior
+ *  hand of the attacker has been proven, and is not mate if the board
+ *  with a superior hand has been disproven.
+ *
+ *  A new entry is put at the head of the bucket and the last one drops
+ *  out. The table is not shared by threads.
+ *
+ */
+template <typename T>
+class HandTable
+{
+
+public:
+
+    /// Number of entries in a bucket
+    static constexpr int    Ways        = 8;
+
+    /// Constructor takes the size in MiB
+    HandTable (size_t);
+
+    /// Destructor
+    ~HandTable ();
+
+    /// Clear all the entries
+    void                    clear      (void);
+
+    /// Store the value for the board and the hand
+    void                    store      (Zobrist::key, Hand::Hand,
+                                        const T &);
+
+    /// Look up the board and the hand
+    bool                    probe      (Zobrist::key, Hand::Hand, T &) const;
+
+    /// Look up the board with a superior hand satisfying the predicate
+    template <typename F>
+    bool                    superior   (Zobrist::key, Hand::Hand, F,
+                                        T &)                          const;
+
+    /// Look up the board with an inferior hand satisfying the predicate
+    template <typename F>
+    bool                    inferior   (Zobrist::key, Hand::Hand, F,
+                                        T &)                          const;
+
+    /// Number of buckets
+    size_t                  buckets    (void)                         const;
+
+private:
+
+    /// Entry
+    struct Entry {
+        Zobrist::key        board;
+        Hand::Hand          hand;
+        T                   value;
+    };
+
+    /// Bucket for the board
+    Entry *                 _bucket    (Zobrist::key)                 const;
+
+    /// void copy constructor
+    HandTable (const HandTable<T> &);
+
+    /// void copy
+    HandTable<T> &          operator=  (const HandTable<T> &);
+
+    /// Entries
+    Entry *                 _table;
+
+    /// Number of buckets
+    size_t                  _buckets;
+
+};
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ---------------------------- implementations ---------------------------- */
+
+/**
+ * Constructor
+ * @param mib size of the table in MiB
+ */
+template <typename T>
+HandTable<T>::HandTable (size_t mib)
+ : _table(nullptr), _buckets((mib << 20) / (sizeof(Entry) * Ways))
+{
+
+    if (_buckets == 0) {
+        throw HandTableException();
+    }
+
+    _table = new Entry[_buckets * Ways];
+    clear();
+
+}
+
+
+
+/**
+ * Destructor
+ * 
+ */
+template <typename T>
+HandTable<T>::~HandTable ()
+{
+
+    delete [] _table;
+
+}
+
+
+
+/**
+ * Clear all the entries
+ * 
+ */
+template <typename T>
+void HandTable<T>::clear (void)
+{
+
+    for (size_t i = 0; i < _buckets * Ways; ++i) {
+        _table[i].board = 0;
+        _table[i].hand  = Hand::Empty;
+    }
+
+}
+
+
+
+/**
+ * Bucket for the board
+ * @param k board key
+ * @return the first entry of the bucket
+ */
+template <typename T>
+inline typename HandTable<T>::Entry * HandTable<T>::_bucket (Zobrist::key k)
+                                                                      const
+{
+
+    return _table + static_cast<size_t>(
+            (static_cast<unsigned __int128>(k) * _buckets) >> 64) * Ways;
+
+}
+
+
+
+/**
+ * Store the value for the board and the hand
+ * @param k board key
+ * @param h hand
+ * @param v value
+ */
+template <typename T>
+void HandTable<T>::store (Zobrist::key k, Hand::Hand h, const T &v)
+{
+
+    Entry *                 b = _bucket(k);
+    int                     i = 0;
+
+    // the same position is updated in place
+    for (; i < Ways - 1; ++i) {
+        if (b[i].board == k && b[i].hand == h) {
+            break;
+        }
+        if (b[i].board == 0) {
+            break;
+        }
+    }
+
+    // others move down to make room at the head
+    for (; i > 0; --i) {
+        b[i] = b[i - 1];
+    }
+
+    b[0].board = k;
+    b[0].hand  = h;
+    b[0].value = v;
+
+}
+
+
+
+/**
+ * Look up the board and the hand
+ * @param k board key
+ * @param h hand
+ * @param v value found
+ * @return true if found
+ */
+template <typename T>
+bool HandTable<T>::probe (Zobrist::key k, Hand::Hand h, T &v) const
+{
+
+    const Entry *           b = _bucket(k);
+
+    for (int i = 0; i < Ways && b[i].board != 0; ++i) {
+        if (b[i].board == k && b[i].hand == h) {
+            v = b[i].value;
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+
+
+/**
+ * Look up the board with a hand superior to (or equal with) the given one
+ * @param k board key
+ * @param h hand
+ * @param f predicate taking the value
+ * @param v value found
+ * @return true if found
+ */
+template <typename T>
+template <typename F>
+bool HandTable<T>::superior (Zobrist::key k, Hand::Hand h, F f, T &v) const
+{
+
+    const Entry *           b = _bucket(k);
+
+    for (int i = 0; i < Ways && b[i].board != 0; ++i) {
+        if (b[i].board == k && Hand::superior(b[i].hand, h) &&
+            f(b[i].value)) {
+            v = b[i].value;
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+
+
+/**
+ * Look up the board with a hand inferior to (or equal with) the given one
+ * @param k board key
+ * @param h hand
+ * @param f predicate taking the value
+ * @param v value found
+ * @return true if found
+ */
+template <typename T>
+template <typename F>
+bool HandTable<T>::inferior (Zobrist::key k, Hand::Hand h, F f, T &v) const
+{
+
+    const Entry *           b = _bucket(k);
+
+    for (int i = 0; i < Ways && b[i].board != 0; ++i) {
+        if (b[i].board == k && Hand::inferior(b[i].hand, h) &&
+            f(b[i].value)) {
+            v = b[i].value;
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+
+
+/**
+ * Number of buckets
+ * @return number of buckets
+ */
+template <typename T>
+inline size_t HandTable<T>::buckets (void) const
+{
+
+    return _buckets;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+// end namespace 'game'
+}
+
+#endif
@@ -42,6 +42,7 @@
 #include <iomanip>
 #include <sstream>
 #include <cstring>
+#include <cstdlib>
 
 #include <Position.h>
 #include <Piece.h>
@@ -256,6 +257,9 @@ Evaluation::Eval            Position::_handsVal [EMPHandsMask + 1]
                               {{0, 0, 0, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 0, 0, 0, 0}}
                             };
 
+// squares around OU, set by kingArea()
+Bitboard                    Position::_kingArea [Square::Squares];
+
 //
 // Context cache on thread local storage
 //
@@ -354,8 +358,15 @@ Color::Color Position::myTurn (const CSASummary &g)
  */
 Position::Position (const Position &v)
  : _keyBoard(v._keyBoard), _keyHands(v._keyHands), _key(v._key),
+#ifdef USE_WIDEHASHKEY
+   _vkeyBoard(v._vkeyBoard), _vkeyHands(v._vkeyHands),
+#endif
+#ifdef USE_SUBHASHKEY
+   _keyPawn(v._keyPawn), _keyKing{v._keyKing[0], v._keyKing[1]},
+#endif
    _kingSB(v._kingSB), _kingSW(v._kingSW), _ocupd(v._ocupd), _empty(v._empty),
-   _exchg(v._exchg), _last(v._last), _next(v._next), _numMoves(v._numMoves)
+   _exchg(v._exchg), _last(v._last), _next(v._next), _numMoves(v._numMoves),
+   _hook(v._hook), _hookArg(v._hookArg)
 {
 
     // copy the board
@@ -376,6 +387,11 @@ Position::Position (const Position &v)
     _piece[Color::Black] = v._piece[Color::Black];
     _piece[Color::White] = v._piece[Color::White];
 
+#ifdef USE_ATTACKCOUNTMAP
+    // copy the attack counts
+    memcpy(_count, v._count, sizeof(_count));
+#endif
+
     // copy doesn't affect TLS cache.
     // we don't have to invoke makeCheck() here.
 #ifndef USE_THREADLOCALSTORAGE
@@ -391,7 +407,7 @@ Position::Position (const Position &v)
  * @param g game summary of CSA connection
  */
 Position::Position (const CSASummary &g)
- : _exchg(0), _numMoves(0)
+ : _exchg(0), _numMoves(0), _hook(nullptr), _hookArg(nullptr)
 {
 
     // CSA expression for position and hands
@@ -478,6 +494,11 @@ Position::Position (const CSASummary &g)
     // hashing
     _hashFull();
 
+#ifdef USE_ATTACKCOUNTMAP
+    // attack counts
+    _countFull();
+#endif
+
     // make check
     makeCheck();
 
@@ -569,6 +590,11 @@ void Position::init (void)
     // hashing
     _hashFull();
 
+#ifdef USE_ATTACKCOUNTMAP
+    // attack counts
+    _countFull();
+#endif
+
     // make check
     makeCheck();
 
@@ -589,6 +615,127 @@ Zobrist::key Position::hash (void) const
 
 
 
+/**
+ * Hash key for the pieces on board
+ * Positions on the same board with the different hands share this key.
+ * @return hash key for the board
+ */
+Zobrist::key Position::hashBoard (void) const
+{
+
+    return _keyBoard;
+
+}
+
+
+
+/**
+ * Pieces in the hand packed in 32 bits
+ * @param c color of the player
+ * @return packed hand
+ */
+Hand::Hand Position::hand (Color::Color c) const
+{
+
+    return Hand::pack(_hands[c]);
+
+}
+
+
+
+/**
+ * Hash key for the FU on board
+ * Positions with the same FU structure share this key, so an evaluator
+ * can cache the terms of the structure in a small table. Building with
+ * SUBKEY=y maintains the key incrementally, otherwise it is calculated
+ * on each call.
+ * @return hash key for FU
+ */
+Zobrist::key Position::hashPawn (void) const
+{
+
+#ifdef USE_SUBHASHKEY
+    return _keyPawn;
+#else
+    return _pawnKey();
+#endif
+
+}
+
+
+
+/**
+ * Hash key for the pieces around OU of the color
+ * The key covers OU itself and the squares set by kingArea(), including
+ * the pieces of the both colors. The pieces in the hands are not
+ * included. Building with SUBKEY=y maintains the key incrementally,
+ * otherwise it is calculated on each call.
+ * @param c color of OU
+ * @return hash key for the area (0 without OU)
+ */
+Zobrist::key Position::hashKing (Color::Color c) const
+{
+
+#ifdef USE_SUBHASHKEY
+    return _keyKing[c];
+#else
+    return _kingKey(c);
+#endif
+
+}
+
+
+
+/**
+ * Set the distance of the squares around OU covered by hashKing()
+ * The area is the squares within the given distance in both files and
+ * ranks. This must be called before any position is made, as the keys
+ * maintained incrementally are not recalculated. Shogi::initialize()
+ * sets the distance 1 (OU and its eight neighbours).
+ * @param d distance from OU
+ */
+void Position::kingArea (int d)
+{
+
+    for (auto &b : _kingArea) {
+        b = Bitboard::Zero;
+    }
+
+    for (auto k : Square::all) {
+        int f = static_cast<int>(Square::toFile(k));
+        int r = static_cast<int>(Square::toRank(k));
+        for (auto s : Square::all) {
+            if (std::abs(static_cast<int>(Square::toFile(s)) - f) <= d &&
+                std::abs(static_cast<int>(Square::toRank(s)) - r) <= d) {
+                _kingArea[k] |= s;
+            }
+        }
+    }
+
+}
+
+
+
+/**
+ * Secondary hash key
+ * Building with WIDEKEY=y maintains another key from the independent
+ * tables, and the pair of the keys works as a 128-bit key. Otherwise
+ * this is the same as hash().
+ * @return secondary hash key for both the board and the hands
+ */
+Zobrist::key Position::verifier (void) const
+{
+
+#ifdef USE_WIDEHASHKEY
+    return _vkeyBoard ^ _vkeyHands;
+#else
+    return _key;
+#endif
+
+}
+
+
+
 /**
  * Bitboard for the occupied squares
  * @return occupied bitboard
@@ -698,6 +845,24 @@ const Bitboard & Position::occupied (Color::Color c) const
 
 
 
+#ifdef USE_ATTACKCOUNTMAP
+/**
+ * Number of the colored pieces reaching to the square. The counts are
+ * maintained incrementally by move(), undo(), drop() and remove().
+ * @param c color
+ * @param sq square of the board
+ * @return number of the pieces
+ */
+int Position::attackers (Color::Color c, Square::Square sq) const
+{
+
+    return _count[c][sq];
+
+}
+#endif
+
+
+
 /**
  * Set next player to move
  * @param c color of the next player
@@ -728,15 +893,30 @@ Move::Move Position::drop (const Move::Move &m)
     // reduce hands
     int &d             = _hands[_next][pc];
     _keyHands         -= Zobrist::hands[_next][pc];
+#ifdef USE_WIDEHASHKEY
+    _vkeyHands        -= Zobrist::verifyHands[_next][pc];
+#endif
     _exchg            -= _handsVal[d--][_next][pc];
     _exchg            += _handsVal[d  ][_next][pc];
 
+#ifdef USE_ATTACKCOUNTMAP
+    // sliding pieces passing through the square
+    Bitboard       sl  = _countRange(to);
+    _countBoard(sl, -1);
+#endif
+
     // drop
     pc                 = Piece::polar(pc, _next);
     _board[to]         = static_cast<unsigned char>(pc);
     _bbord[pc]        ^= Bitboard::Square[to];
     _piece[_next]     ^= Bitboard::Square[to];
     _keyBoard         ^= Zobrist::position[to][pc];
+#ifdef USE_WIDEHASHKEY
+    _vkeyBoard        ^= Zobrist::verifyPosition[to][pc];
+#endif
+#ifdef USE_SUBHASHKEY
+    _subKey(to, pc);
+#endif
     _exchg            += _pieceVal[pc];
 
     // update occupied bitboard
@@ -748,6 +928,12 @@ Move::Move Position::drop (const Move::Move &m)
     // update whole hash
     _key               = _keyBoard ^ _keyHands;
 
+#ifdef USE_ATTACKCOUNTMAP
+    // attack counts
+    _countPiece(to, pc, 1);
+    _countBoard(sl,     1);
+#endif
+
     // flip the turn
     _last              = _next;
     _next              = Color::flip(_next);
@@ -755,6 +941,11 @@ Move::Move Position::drop (const Move::Move &m)
     // number of moves
     ++_numMoves;
 
+    // let the search prefetch its table while making the cache
+    if (_hook != nullptr) {
+        _hook(*this, _hookArg);
+    }
+
     // make cache
     makeCheck();
 
@@ -782,15 +973,32 @@ void Position::remove (const Move::Move &m)
     // increment hands
     int &d             = _hands[_next][pc];
     _keyHands         += Zobrist::hands[_next][pc];
+#ifdef USE_WIDEHASHKEY
+    _vkeyHands        += Zobrist::verifyHands[_next][pc];
+#endif
     _exchg            -= _handsVal[d++][_next][pc];
     _exchg            += _handsVal[d  ][_next][pc];
 
     // remove
     pc                 = Piece::polar(pc, _next);
+
+#ifdef USE_ATTACKCOUNTMAP
+    // sliding pieces passing through the square
+    Bitboard       sl  = _countRange(to) & Bitboard::Invert[to];
+    _countBoard(sl, -1);
+    _countPiece(to, pc, -1);
+#endif
+
     _board[to]         = static_cast<unsigned char>(Piece::EMP);
     _bbord[pc]        ^= Bitboard::Square[to];
     _piece[_next]     ^= Bitboard::Square[to];
     _keyBoard         ^= Zobrist::position[to][pc];
+#ifdef USE_WIDEHASHKEY
+    _vkeyBoard        ^= Zobrist::verifyPosition[to][pc];
+#endif
+#ifdef USE_SUBHASHKEY
+    _subKey(to, pc);
+#endif
     _exchg            -= _pieceVal[pc];
 
     // update occupied bitboard
@@ -802,6 +1010,11 @@ void Position::remove (const Move::Move &m)
     // update whole hash
     _key               = _keyBoard ^ _keyHands;
 
+#ifdef USE_ATTACKCOUNTMAP
+    // attack counts
+    _countBoard(sl, 1);
+#endif
+
     // number of moves
     --_numMoves;
 
@@ -832,11 +1045,27 @@ Move::Move Position::move (const Move::Move &m)
     Square::Square fm  = Move::from(m);
     Square::Square to  = Move::to  (m);
 
+#ifdef USE_ATTACKCOUNTMAP
+    // sliding pieces passing through the squares other than the moving
+    // and the captured piece
+    Bitboard       sl  = (_countRange(fm) | _countRange(to))
+                       & Bitboard::Invert[fm] & Bitboard::Invert[to];
+    _countBoard(sl, -1);
+    _countPiece(fm, _board[fm], -1);
+    _countPiece(to, _board[to], -1);
+#endif
+
     // moved piece 
     Piece ::Piece  pc  = _board[fm];
     _bbord[pc]        ^= Bitboard::Square[fm];
     _piece[_next]     ^= Bitboard::Square[fm];
     _keyBoard         ^= Zobrist::position[fm][pc];
+#ifdef USE_WIDEHASHKEY
+    _vkeyBoard        ^= Zobrist::verifyPosition[fm][pc];
+#endif
+#ifdef USE_SUBHASHKEY
+    _subKey(fm, pc);
+#endif
     _exchg            -= _pieceVal[pc];
     pc                ^= ((m & Move::Promote) >> (Move ::PromotionShift -
                                                    Piece::PromotionShift   ));
@@ -847,6 +1076,12 @@ Move::Move Position::move (const Move::Move &m)
     _bbord[cp]        ^= Bitboard::Square[to];
     _piece[_last]     &= Bitboard::Invert[to];
     _keyBoard         ^= Zobrist::position[to][cp];
+#ifdef USE_WIDEHASHKEY
+    _vkeyBoard        ^= Zobrist::verifyPosition[to][cp];
+#endif
+#ifdef USE_SUBHASHKEY
+    _subKey(to, cp);
+#endif
     _exchg            -= _pieceVal[cp];
     cp                &= Piece::Mask;
 
@@ -858,11 +1093,20 @@ Move::Move Position::move (const Move::Move &m)
     _bbord[pc]        ^= Bitboard::Square[to];
     _piece[_next]     ^= Bitboard::Square[to];
     _keyBoard         ^= Zobrist::position[to][pc];
+#ifdef USE_WIDEHASHKEY
+    _vkeyBoard        ^= Zobrist::verifyPosition[to][pc];
+#endif
+#ifdef USE_SUBHASHKEY
+    _subKey(to, pc);
+#endif
     _exchg            += _pieceVal[pc];
 
     // hands
     int &d             = _hands[_next][cp];
     _keyHands         += Zobrist::hands[_next][cp];
+#ifdef USE_WIDEHASHKEY
+    _vkeyHands        += Zobrist::verifyHands[_next][cp];
+#endif
     _exchg            -= _handsVal[d++][_next][cp];
     d                 &= EMPHandsMask;
     _exchg            += _handsVal[d  ][_next][cp];
@@ -876,6 +1120,12 @@ Move::Move Position::move (const Move::Move &m)
     // update whole hash
     _key               = _keyBoard ^ _keyHands;
 
+#ifdef USE_ATTACKCOUNTMAP
+    // attack counts
+    _countPiece(to, pc, 1);
+    _countBoard(sl,     1);
+#endif
+
     // flip the turn
     _last              = _next;
     _next              = Color::flip(_next);
@@ -891,6 +1141,18 @@ Move::Move Position::move (const Move::Move &m)
         _kingSW = _bbord[Piece::WOU].lsb();
     }
 
+#ifdef USE_SUBHASHKEY
+    // OU moved has another area around it
+    if (pc == Piece::BOU || pc == Piece::WOU) {
+        _keyKing[Piece::color(pc)] = _kingKey(Piece::color(pc));
+    }
+#endif
+
+    // let the search prefetch its table while making the cache
+    if (_hook != nullptr) {
+        _hook(*this, _hookArg);
+    }
+
     // make check
     makeCheck();
 
@@ -900,6 +1162,27 @@ Move::Move Position::move (const Move::Move &m)
 
 
 
+/**
+ * Set the callback fired by the moves
+ * move() and drop() call it as soon as the new hash keys and the turn are
+ * known, before makeCheck() computes the checks and the pins, which are
+ * not yet valid in the callback. A search typically prefetches the entry
+ * of its transposition table for hash() there, so the memory latency is
+ * overlapped with the computation of the checks. The callback is copied
+ * along with the position.
+ * @param h callback (nullptr to remove)
+ * @param arg argument passed to the callback
+ */
+void Position::hook (Hook h, void *arg)
+{
+
+    _hook    = h;
+    _hookArg = arg;
+
+}
+
+
+
 /**
  * Und the last move, assuming the given move is always legal 
  * @param m move to perform
@@ -921,11 +1204,25 @@ void Position::undo (const Move::Move &m)
     Square::Square fm  = Move::from(m);
     Square::Square to  = Move::to  (m);
 
+#ifdef USE_ATTACKCOUNTMAP
+    // sliding pieces passing through the squares other than the moved piece
+    Bitboard       sl  = (_countRange(fm) | _countRange(to))
+                       & Bitboard::Invert[to];
+    _countBoard(sl, -1);
+    _countPiece(to, _board[to], -1);
+#endif
+
     // moved piece
     Piece::Piece   pc  = _board[to];
     _bbord[pc]        ^= Bitboard::Square[to];
     _piece[_next]     ^= Bitboard::Square[to];
     _keyBoard         ^= Zobrist::position[to][pc];
+#ifdef USE_WIDEHASHKEY
+    _vkeyBoard        ^= Zobrist::verifyPosition[to][pc];
+#endif
+#ifdef USE_SUBHASHKEY
+    _subKey(to, pc);
+#endif
     _exchg            -= _pieceVal[pc];
     pc                ^= ((m & Move::Promote) >> (Move ::PromotionShift -
                                                    Piece::PromotionShift   ));
@@ -938,6 +1235,12 @@ void Position::undo (const Move::Move &m)
     _bbord[pc]        ^= Bitboard::Square[fm];
     _piece[_next]     ^= Bitboard::Square[fm];
     _keyBoard         ^= Zobrist::position[fm][pc];
+#ifdef USE_WIDEHASHKEY
+    _vkeyBoard        ^= Zobrist::verifyPosition[fm][pc];
+#endif
+#ifdef USE_SUBHASHKEY
+    _subKey(fm, pc);
+#endif
     _exchg            += _pieceVal[pc];
 
     // square moved to
@@ -945,12 +1248,21 @@ void Position::undo (const Move::Move &m)
     _bbord[cp]        ^= Bitboard::Square[to];
     _piece[_last]     ^= (cp == Piece::EMP ? Bitboard::Zero : Bitboard::Square[to]);
     _keyBoard         ^= Zobrist::position[to][cp];
+#ifdef USE_WIDEHASHKEY
+    _vkeyBoard        ^= Zobrist::verifyPosition[to][cp];
+#endif
+#ifdef USE_SUBHASHKEY
+    _subKey(to, cp);
+#endif
     _exchg            += _pieceVal[cp];
     cp                &= Piece::Mask;
 
     // hands
     int &d             = _hands[_next][cp];
     _keyHands         -= Zobrist::hands[_next][cp];
+#ifdef USE_WIDEHASHKEY
+    _vkeyHands        -= Zobrist::verifyHands[_next][cp];
+#endif
     _exchg            -= _handsVal[d--][_next][cp];
     d                 &= EMPHandsMask;
     _exchg            += _handsVal[d  ][_next][cp];
@@ -965,6 +1277,13 @@ void Position::undo (const Move::Move &m)
     // update whole hash
     _key               = _keyBoard ^ _keyHands;
 
+#ifdef USE_ATTACKCOUNTMAP
+    // attack counts
+    _countPiece(fm, _board[fm], 1);
+    _countPiece(to, _board[to], 1);
+    _countBoard(sl,             1);
+#endif
+
     // number of moves
     --_numMoves;
 
@@ -976,6 +1295,13 @@ void Position::undo (const Move::Move &m)
         _kingSW = _bbord[Piece::WOU].lsb();
     }
 
+#ifdef USE_SUBHASHKEY
+    // OU moved has another area around it
+    if (pc == Piece::BOU || pc == Piece::WOU) {
+        _keyKing[Piece::color(pc)] = _kingKey(Piece::color(pc));
+    }
+#endif
+
     // make check
     makeCheck();
  
@@ -1060,6 +1386,25 @@ bool Position::dusty (const Move::Move &m) const
 
 
 
+/**
+ * Check if the last move left OU of the last player in check
+ * dusty() finds it among the moves generated, which does not work when
+ * the next player is in check and only the evasions are generated.
+ * @return true if OU of the last player is in check, false otherwise.
+ */
+bool Position::exposed (void)
+{
+
+    if (_last == Color::Black) {
+        return _kingSB != Square::SQVD && _chkEffectW(_kingSB);
+    }
+
+    return _kingSW != Square::SQVD && _chkEffectB(_kingSW);
+
+}
+
+
+
 /**
  * Check if black will capture WOU
  * @param m move to perform
@@ -1204,6 +1549,15 @@ Position & Position::operator= (const Position &rhs)
     _keyBoard   = rhs._keyBoard;
     _keyHands   = rhs._keyHands;
     _key        = rhs._key;
+#ifdef USE_WIDEHASHKEY
+    _vkeyBoard  = rhs._vkeyBoard;
+    _vkeyHands  = rhs._vkeyHands;
+#endif
+#ifdef USE_SUBHASHKEY
+    _keyPawn    = rhs._keyPawn;
+    _keyKing[Color::Black] = rhs._keyKing[Color::Black];
+    _keyKing[Color::White] = rhs._keyKing[Color::White];
+#endif
     _kingSB     = rhs._kingSB;
     _kingSW     = rhs._kingSW;
     _ocupd      = rhs._ocupd;
@@ -1212,6 +1566,8 @@ Position & Position::operator= (const Position &rhs)
     _last       = rhs._last;
     _next       = rhs._next;
     _numMoves   = rhs._numMoves;
+    _hook       = rhs._hook;
+    _hookArg    = rhs._hookArg;
 
 
     // copy the board
@@ -1232,6 +1588,11 @@ Position & Position::operator= (const Position &rhs)
     _piece[Color::Black] = rhs._piece[Color::Black];
     _piece[Color::White] = rhs._piece[Color::White];
 
+#ifdef USE_ATTACKCOUNTMAP
+    // copy the attack counts
+    memcpy(_count, rhs._count, sizeof(_count));
+#endif
+
     // copy doesn't affect TLS cache.
     // we don't have to invoke makeCheck() here.
 #ifndef USE_THREADLOCALSTORAGE
@@ -1991,8 +2352,7 @@ void Position::delChckW (Array<Move::Move, Move::Max> &m)
 inline void _normlMove (Bitboard &to, Square::Square sq,
                                             Array<Move::Move, Move::Max> &m)
 {
-    while (to) {
-        auto s = to.pick();
+    for (auto s : to) {
         m.add(Move::move(sq, s));
     }
 }
@@ -2008,8 +2368,7 @@ inline void _normlMove (Bitboard &to, Square::Square sq,
 inline void _promtMove (Bitboard &to, Square::Square sq,
                                             Array<Move::Move, Move::Max> &m)
 {
-    while (to) {
-        auto s = to.pick();
+    for (auto s : to) {
         m.add(Move::promote(sq, s));
     }
 }
@@ -2024,8 +2383,7 @@ inline void _promtMove (Bitboard &to, Square::Square sq,
 inline void _pandnMove (Bitboard &to, Square::Square sq,
                                             Array<Move::Move, Move::Max> &m)
 {
-    while (to) {
-        auto s = to.pick();
+    for (auto s : to) {
         m.add(Move::move   (sq, s));
         m.add(Move::promote(sq, s));
     }
@@ -2042,8 +2400,7 @@ inline void _pandnMove (Bitboard &to, Square::Square sq,
 inline void Position::_minorMove (Bitboard &to, Square::Square sq,
                                             Array<Move::Move, Move::Max> &m)
 {
-    while (to) {
-        auto s = to.pick();
+    for (auto s : to) {
          m.add(Move::promote(sq, s));
         _m.add(Move::move   (sq, s));
     }
@@ -2058,8 +2415,7 @@ inline void Position::_minorMove (Bitboard &to, Square::Square sq,
  */
 inline void Position::_cacheMove (Bitboard &to, Square::Square sq)
 {
-    while (to) {
-        auto s = to.pick();
+    for (auto s : to) {
         _m.add(Move::move(sq, s));
     }
 }
@@ -2074,8 +2430,7 @@ inline void Position::_cacheMove (Bitboard &to, Square::Square sq)
  */
 inline void _dropMove (Piece::Piece pc, Bitboard &to, Array<Move::Move, Move::Max> &m)
 {
-    while (to) {
-        auto s = to.pick();
+    for (auto s : to) {
         m.add(Move::drop(pc, s));
     }
 }
@@ -2119,16 +2474,13 @@ void Position::_moveBFU (Array<Move::Move, Move::Max> &m)
     auto en = ef & BlackPNMask;
     auto eo = ef & NFBFU;
     auto ep = ef & BlackPRMask;
-    while (en) {
-        auto sq = en.pick();
+    for (auto sq : en) {
          m.add(Move::move   (sq + Square::DWARD, sq));
     }
-    while (eo) {
-        auto sq = eo.pick();
+    for (auto sq : eo) {
         _m.add(Move::move   (sq + Square::DWARD, sq));
     }
-    while (ep) {
-        auto sq = ep.pick();
+    for (auto sq : ep) {
          m.add(Move::promote(sq + Square::DWARD, sq));
     }
 
@@ -2147,12 +2499,10 @@ void Position::_fastBFU (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
     auto ef = (_bbord[Piece::BFU] >> 1) & mask;
     auto en = ef & BlackPNMask;
     auto ep = ef & BlackPRMask;
-    while (en) {
-        auto sq = en.pick();
+    for (auto sq : en) {
         m.add(Move::move   (sq + Square::DWARD, sq));
     }
-    while (ep) {
-        auto sq = ep.pick();
+    for (auto sq : ep) {
         m.add(Move::promote(sq + Square::DWARD, sq));
     }
 
@@ -2171,16 +2521,13 @@ void Position::_chckBFU (Array<Move::Move, Move::Max> &m)
     auto en = ef & BlackPNMask & Effect::AD(_kingSW, Piece::WFU);
     auto eo = ef & NFBFU       & Effect::AD(_kingSW, Piece::WFU);
     auto ep = ef & BlackPRMask & Effect::AD(_kingSW, Piece::WKI);
-    while (en) {
-        auto sq = en.pick();
+    for (auto sq : en) {
          m.add(Move::move   (sq + Square::DWARD, sq));
     }
-    while (eo) {
-        auto sq = eo.pick();
+    for (auto sq : eo) {
         _m.add(Move::move   (sq + Square::DWARD, sq));
     }
-    while (ep) {
-        auto sq = ep.pick();
+    for (auto sq : ep) {
          m.add(Move::promote(sq + Square::DWARD, sq));
     }
 
@@ -2198,12 +2545,10 @@ void Position::_cfstBFU (Array<Move::Move, Move::Max> &m)
     auto ef = (_bbord[Piece::BFU] >> 1) & _empty;
     auto en = ef & BlackPNMask & Effect::AD(_kingSW, Piece::WFU);
     auto ep = ef & BlackPRMask & Effect::AD(_kingSW, Piece::WKI);
-    while (en) {
-        auto sq = en.pick();
+    for (auto sq : en) {
          m.add(Move::move   (sq + Square::DWARD, sq));
     }
-    while (ep) {
-        auto sq = ep.pick();
+    for (auto sq : ep) {
          m.add(Move::promote(sq + Square::DWARD, sq));
     }
 
@@ -2224,16 +2569,13 @@ void Position::_moveWFU (Array<Move::Move, Move::Max> &m)
     auto en = ef & WhitePNMask;
     auto eo = ef & NFWFU;
     auto ep = ef & WhitePRMask;
-    while (en) {
-        auto sq = en.pick();
+    for (auto sq : en) {
          m.add(Move::move   (sq + Square::UWARD, sq));
     }
-    while (eo) {
-        auto sq = eo.pick();
+    for (auto sq : eo) {
         _m.add(Move::move   (sq + Square::UWARD, sq));
     }
-    while (ep) {
-        auto sq = ep.pick();
+    for (auto sq : ep) {
          m.add(Move::promote(sq + Square::UWARD, sq));
     }
 
@@ -2252,12 +2594,10 @@ void Position::_fastWFU (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
     auto ef = (_bbord[Piece::WFU] << 1) & mask;
     auto en = ef & WhitePNMask;
     auto ep = ef & WhitePRMask;
-    while (en) {
-        auto sq = en.pick();
+    for (auto sq : en) {
         m.add(Move::move   (sq + Square::UWARD, sq));
     }
-    while (ep) {
-        auto sq = ep.pick();
+    for (auto sq : ep) {
         m.add(Move::promote(sq + Square::UWARD, sq));
     }
 
@@ -2276,16 +2616,13 @@ void Position::_chckWFU (Array<Move::Move, Move::Max> &m)
     auto en = ef & WhitePNMask & Effect::AD(_kingSB, Piece::BFU);
     auto eo = ef & NFWFU       & Effect::AD(_kingSB, Piece::BFU);
     auto ep = ef & WhitePRMask & Effect::AD(_kingSB, Piece::BKI);
-    while (en) {
-        auto sq = en.pick();
+    for (auto sq : en) {
          m.add(Move::move   (sq + Square::UWARD, sq));
     }
-    while (eo) {
-        auto sq = eo.pick();
+    for (auto sq : eo) {
         _m.add(Move::move   (sq + Square::UWARD, sq));
     }
-    while (ep) {
-        auto sq = ep.pick();
+    for (auto sq : ep) {
          m.add(Move::promote(sq + Square::UWARD, sq));
     }
 
@@ -2303,12 +2640,10 @@ void Position::_cfstWFU (Array<Move::Move, Move::Max> &m)
     auto ef = (_bbord[Piece::WFU] << 1) & _empty;
     auto en = ef & WhitePNMask & Effect::AD(_kingSB, Piece::BFU);
     auto ep = ef & WhitePRMask & Effect::AD(_kingSB, Piece::BKI);
-    while (en) {
-        auto sq = en.pick();
+    for (auto sq : en) {
          m.add(Move::move   (sq + Square::UWARD, sq));
     }
-    while (ep) {
-        auto sq = ep.pick();
+    for (auto sq : ep) {
          m.add(Move::promote(sq + Square::UWARD, sq));
     }
 
@@ -2326,8 +2661,7 @@ int Position::_numBKY (void)
     auto pp  = _bbord[Piece::BKY] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += (Effect::KB(sq, _ocupd) & (~_piece[Color::Black])).popcnt();
     }
 
@@ -2347,8 +2681,7 @@ int Position::_numWKY (void)
     auto pp  = _bbord[Piece::WKY] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += (Effect::KW(sq, _ocupd) & (~_piece[Color::White])).popcnt();
     }
 
@@ -2367,8 +2700,7 @@ void Position::_moveBKY (Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::BKY] & _pinnd;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::KB(sq, _ocupd) & (~_piece[Color::Black]);
         auto en = ef & NFBKY;
         auto ep = ef & BlackPRMask;
@@ -2390,8 +2722,7 @@ void Position::_fastBKY (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::BKY];
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::KB(sq, _ocupd) & mask;
         auto en = ef & NFBKY;
         auto ep = ef & BlackPRMask;
@@ -2415,8 +2746,7 @@ void Position::_chckBKY (const Bitboard &p, const Bitboard &em,
 
     Bitboard pp(p);
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::KB(sq, _ocupd) & em;
         auto en = ef & NFBKY       & Effect::KW(_kingSW, _ocupd);
         auto ep = ef & BlackPRMask & Effect::AD(_kingSW, Piece::WKI);
@@ -2437,8 +2767,7 @@ void Position::_moveWKY (Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::WKY] & _pinnd;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::KW(sq, _ocupd) & (~_piece[Color::White]);
         auto en = ef & NFWKY;
         auto ep = ef & WhitePRMask;
@@ -2460,8 +2789,7 @@ void Position::_fastWKY (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::WKY];
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::KW(sq, _ocupd) & mask;
         auto en = ef & NFWKY;
         auto ep = ef & WhitePRMask;
@@ -2485,8 +2813,7 @@ void Position::_chckWKY (const Bitboard &p, const Bitboard &em,
 
     Bitboard pp(p);
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::KW(sq, _ocupd) & em;
         auto en = ef & NFWKY       & Effect::KB(_kingSB, _ocupd);
         auto ep = ef & WhitePRMask & Effect::AD(_kingSB, Piece::BKI);
@@ -2508,8 +2835,7 @@ int Position::_numBKE (void)
     auto pp  = _bbord[Piece::BKE] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += (Effect::AD(sq, Piece::BKE) & (~_piece[Color::Black])).popcnt();
     }
 
@@ -2529,8 +2855,7 @@ int Position::_numWKE (void)
     auto pp  = _bbord[Piece::WKE] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += (Effect::AD(sq, Piece::WKE) & (~_piece[Color::White])).popcnt();
     }
 
@@ -2549,8 +2874,7 @@ void Position::_moveBKE (Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::BKE] & _pinnd;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::AD(sq, Piece::BKE) & (~_piece[Color::Black]);
         auto en = ef & NFBKE;
         auto ep = ef & BlackPRMask;
@@ -2571,8 +2895,7 @@ void Position::_fastBKE (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::BKE];
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::AD(sq, Piece::BKE) & mask;
         auto en = ef & NFBKE;
         auto ep = ef & BlackPRMask;
@@ -2596,8 +2919,7 @@ void Position::_chckBKE (const Bitboard &p, const Bitboard &em,
 
     Bitboard pp(p);
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::AD(sq, Piece::BKE) & em;
         auto en = ef & NFBKE       & Effect::AD(_kingSW, Piece::WKE);
         auto ep = ef & BlackPRMask & Effect::AD(_kingSW, Piece::WKI);
@@ -2618,8 +2940,7 @@ void Position::_moveWKE (Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::WKE] & _pinnd;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::AD(sq, Piece::WKE) & (~_piece[Color::White]);
         auto en = ef & NFWKE;
         auto ep = ef & WhitePRMask;
@@ -2641,8 +2962,7 @@ void Position::_fastWKE (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::WKE];
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::AD(sq, Piece::WKE) & mask;
         auto en = ef & NFWKE;
         auto ep = ef & WhitePRMask;
@@ -2666,8 +2986,7 @@ void Position::_chckWKE (const Bitboard &p, const Bitboard &em,
 
     Bitboard pp(p);
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::AD(sq, Piece::WKE) & em;
         auto en = ef & NFWKE       & Effect::AD(_kingSB, Piece::BKE);
         auto ep = ef & WhitePRMask & Effect::AD(_kingSB, Piece::BKI);
@@ -2689,8 +3008,7 @@ int Position::_numBGI (void)
     auto pp  = _bbord[Piece::BGI] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += (Effect::AD(sq, Piece::BGI) & (~_piece[Color::Black])).popcnt();
     }
 
@@ -2710,8 +3028,7 @@ int Position::_numWGI (void)
     auto pp  = _bbord[Piece::WGI] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += (Effect::AD(sq, Piece::WGI) & (~_piece[Color::White])).popcnt();
     }
 
@@ -2732,12 +3049,10 @@ void Position::_moveBGI (Array<Move::Move, Move::Max> &m)
     auto pc = p & BlackPNMask;
     auto pp = p & BlackPRMask;
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         _moveBGI(~_piece[Color::Black], sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _prmtBGI(~_piece[Color::Black], sq, m);
     }
 
@@ -2757,12 +3072,10 @@ void Position::_fastBGI (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
     auto pc = p & BlackPNMask;
     auto pp = p & BlackPRMask;
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         _moveBGI(mask, sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _prmtBGI(mask, sq, m);
     }
 
@@ -2784,16 +3097,14 @@ void Position::_chckBGI (const Bitboard &p, const Bitboard &em,
     auto pp = p  & BlackPRMask;
     auto mg = em & Effect::AD(_kingSW, Piece::WGI);
     auto mk = em & Effect::AD(_kingSW, Piece::WKI);
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         auto ef = Effect::AD(sq, Piece::BGI);
         auto en = ef & mg;                     // np -> (np | pr) without promotion
         auto ep = ef & BlackPRMask & mk;       // np -> pr with promotion
         _normlMove(en, sq, m);
         _promtMove(ep, sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::AD(sq, Piece::BGI);
         auto en = ef & mg;                      // pr -> (np | pr) without promotion
         auto ep = ef & mk;                      // pr -> (np | pr) with promotion
@@ -2816,12 +3127,10 @@ void Position::_moveWGI (Array<Move::Move, Move::Max> &m)
     auto pc = p & WhitePNMask;
     auto pp = p & WhitePRMask;
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         _moveWGI(~_piece[Color::White], sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _prmtWGI(~_piece[Color::White], sq, m);
     }
 
@@ -2841,12 +3150,10 @@ void Position::_fastWGI (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
     auto pc = p & WhitePNMask;
     auto pp = p & WhitePRMask;
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         _moveWGI(mask, sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _prmtWGI(mask, sq, m);
     }
 
@@ -2868,16 +3175,14 @@ void Position::_chckWGI (const Bitboard &p, const Bitboard &em,
     auto pp = p  & WhitePRMask;
     auto mg = em & Effect::AD(_kingSB, Piece::BGI);
     auto mk = em & Effect::AD(_kingSB, Piece::BKI);
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         auto ef = Effect::AD(sq, Piece::WGI);
         auto en = ef & mg;                      // np -> (np | pr) without promotion
         auto ep = ef & WhitePRMask & mk;        // np -> pr with promotion
         _normlMove(en, sq, m);
         _promtMove(ep, sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::AD(sq, Piece::WGI);
         auto en = ef & mg;
         auto ep = ef & mk;
@@ -2975,8 +3280,7 @@ int Position::_numBKI (void)
     int  num = 0;
 
     pp &= _pinnd;
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += (Effect::AD(sq, Piece::BKI) & (~_piece[Color::Black])).popcnt();
     }
 
@@ -2998,8 +3302,7 @@ int Position::_numWKI (void)
     int  num = 0;
 
     pp &= _pinnd;
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += (Effect::AD(sq, Piece::WKI) & (~_piece[Color::White])).popcnt();
     }
 
@@ -3020,8 +3323,7 @@ void Position::_moveBKI (Array<Move::Move, Move::Max> &m)
               _bbord[Piece::BNY] | _bbord[Piece::BNK] | _bbord[Piece::BNG];
 
     pp &= _pinnd;
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _moveBKI(~_piece[Color::Black], sq, m);
     }
 
@@ -3040,8 +3342,7 @@ void Position::_fastBKI (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
     auto pp = _bbord[Piece::BKI] | _bbord[Piece::BTO] |
               _bbord[Piece::BNY] | _bbord[Piece::BNK] | _bbord[Piece::BNG];
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _moveBKI(mask, sq, m);
     }
 
@@ -3061,8 +3362,7 @@ void Position::_chckBKI (const Bitboard &em, Array<Move::Move, Move::Max> &m)
               _bbord[Piece::BNY] | _bbord[Piece::BNK] | _bbord[Piece::BNG];
 
     pp &= _pinnd;
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto mk = em & Effect::AD(_kingSW, Piece::WKI);
         _moveBKI(mk, sq, m);
     }
@@ -3082,8 +3382,7 @@ void Position::_moveWKI (Array<Move::Move, Move::Max> &m)
                _bbord[Piece::WNY] | _bbord[Piece::WNK] | _bbord[Piece::WNG];
 
     pp &= _pinnd;
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _moveWKI(~_piece[Color::White], sq, m);
     }
 
@@ -3102,8 +3401,7 @@ void Position::_fastWKI (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
     auto pp  = _bbord[Piece::WKI] | _bbord[Piece::WTO] |
                _bbord[Piece::WNY] | _bbord[Piece::WNK] | _bbord[Piece::WNG];
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _moveWKI(mask, sq, m);
     }
 
@@ -3123,8 +3421,7 @@ void Position::_chckWKI (const Bitboard &em, Array<Move::Move, Move::Max> &m)
                _bbord[Piece::WNY] | _bbord[Piece::WNK] | _bbord[Piece::WNG];
 
     pp &= _pinnd;
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto mk = em & Effect::AD(_kingSB, Piece::BKI);
         _moveWKI(mk, sq, m);
     }
@@ -3177,8 +3474,7 @@ int Position::_numBUM (void)
     auto pp  = _bbord[Piece::BUM] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += ((Effect::OC(sq) | Effect::KA(sq, _ocupd))
                                 & (~_piece[Color::Black])).popcnt();
     }
@@ -3199,8 +3495,7 @@ int Position::_numWUM (void)
     auto pp  = _bbord[Piece::WUM] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += ((Effect::OC(sq) | Effect::KA(sq, _ocupd))
                                 & (~_piece[Color::White])).popcnt();
     }
@@ -3220,8 +3515,7 @@ void Position::_moveBUM (Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::BUM] & _pinnd;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _moveUM(~_piece[Color::Black], sq, m);
     }
 
@@ -3239,8 +3533,7 @@ void Position::_fastBUM (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::BUM];
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _moveUM(mask, sq, m);
     }
 
@@ -3260,8 +3553,7 @@ void Position::_chckBUM (const Bitboard &p, const Bitboard &em,
 
     Bitboard pp(p);
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto mk = em & (Effect::KA(_kingSW, _ocupd) | Effect::OC(_kingSW));
         _moveUM(mk, sq, m);
     }
@@ -3279,8 +3571,7 @@ void Position::_moveWUM (Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::WUM] & _pinnd;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _moveUM(~_piece[Color::White], sq, m);
     }
 
@@ -3298,8 +3589,7 @@ void Position::_fastWUM (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::WUM];
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _moveUM(mask, sq, m);
     }
 
@@ -3319,8 +3609,7 @@ void Position::_chckWUM (const Bitboard &p, const Bitboard &em,
 
     Bitboard pp(p);
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto mk = em & (Effect::KA(_kingSB, _ocupd) | Effect::OC(_kingSB));
         _moveUM(mk, sq, m);
     }
@@ -3356,8 +3645,7 @@ int Position::_numBRY (void)
     auto pp  = _bbord[Piece::BRY] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += ((Effect::OC(sq) | Effect::HI(sq, _ocupd))
                                 & (~_piece[Color::Black])).popcnt();
     }
@@ -3378,8 +3666,7 @@ int Position::_numWRY (void)
     auto pp  = _bbord[Piece::WRY] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += ((Effect::OC(sq) | Effect::HI(sq, _ocupd))
                                 & (~_piece[Color::White])).popcnt();
     }
@@ -3399,8 +3686,7 @@ void Position::_moveBRY (Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::BRY] & _pinnd;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _moveRY(~_piece[Color::Black], sq, m);
     }
 
@@ -3418,8 +3704,7 @@ void Position::_fastBRY (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::BRY];
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _moveRY(mask, sq, m);
     }
 
@@ -3439,8 +3724,7 @@ void Position::_chckBRY (const Bitboard &p, const Bitboard &em,
 
     Bitboard pp(p);
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto mk = em & (Effect::HI(_kingSW, _ocupd) | Effect::OC(_kingSW));
         _moveRY(mk, sq, m);
     }
@@ -3458,8 +3742,7 @@ void Position::_moveWRY (Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::WRY] & _pinnd;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _moveRY(~_piece[Color::White], sq, m);
     }
 
@@ -3477,8 +3760,7 @@ void Position::_fastWRY (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
 
     auto pp = _bbord[Piece::WRY];
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _moveRY(mask, sq, m);
     }
 
@@ -3498,8 +3780,7 @@ void Position::_chckWRY (const Bitboard &p, const Bitboard &em,
 
     Bitboard pp(p);
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto mk = em & (Effect::HI(_kingSB, _ocupd) | Effect::OC(_kingSB));
         _moveRY(mk, sq, m);
     }
@@ -3535,8 +3816,7 @@ int Position::_numBKA (void)
     auto pp  = _bbord[Piece::BKA] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += (Effect::KA(sq, _ocupd) & (~_piece[Color::Black])).popcnt();
     }
 
@@ -3555,8 +3835,7 @@ int Position::_numWKA (void)
     auto pp  = _bbord[Piece::WKA] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += (Effect::KA(sq, _ocupd) & (~_piece[Color::White])).popcnt();
     }
 
@@ -3576,12 +3855,10 @@ void Position::_moveBKA (Array<Move::Move, Move::Max> &m)
     auto pc = p & BlackPNMask;
     auto pp = p & BlackPRMask;
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         _moveBKA(~_piece[Color::Black], sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _promtKA(~_piece[Color::Black], sq, m);
     }
 
@@ -3601,12 +3878,10 @@ void Position::_fastBKA (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
     auto pc = p & BlackPNMask;
     auto pp = p & BlackPRMask;
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         _fastBKA(mask, sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _pfastKA(mask, sq, m);
     }
 
@@ -3629,8 +3904,7 @@ void Position::_chckBKA (const Bitboard &p, const Bitboard &em,
     auto mk = em & Effect::KA(_kingSW, _ocupd);
     auto mu = mk | (Effect::OC(_kingSW) & em );
 
-    while (pc) {
-        auto sq  = pc.pick();
+    for (auto sq : pc) {
         auto ef  = Effect::KA(sq, _ocupd);
         auto en  = ef & BlackPNMask & mk;   // np -> np
              ef &= BlackPRMask;
@@ -3640,8 +3914,7 @@ void Position::_chckBKA (const Bitboard &p, const Bitboard &em,
         _cacheMove(eo, sq);
         _promtMove(ep, sq, m);
     }
-    while (pp) {
-        auto sq  = pp.pick();
+    for (auto sq : pp) {
         auto ef  = Effect::KA(sq, _ocupd);
         auto eo  = ef & mk;                 // pr -> (np | pr) without promotion
         auto ep  = ef & mu;                 // pr -> (np | pr) with promotion
@@ -3667,16 +3940,14 @@ void Position::_cfstBKA (Array<Move::Move, Move::Max> &m)
     auto mk = Effect::KA(_kingSW, _ocupd) & _empty;
     auto mu = mk | (Effect::OC(_kingSW)   & _empty);
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         auto ef = Effect::KA(sq, _ocupd);
         auto en = ef & BlackPNMask & mk;    // np -> np
         auto ep = ef & BlackPRMask & mu;    // np -> pr with promotion
         _normlMove(en, sq, m);
         _promtMove(ep, sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ep = Effect::KA(sq, _ocupd) & mu;
         _promtMove(ep, sq, m);
     }
@@ -3696,12 +3967,10 @@ void Position::_moveWKA (Array<Move::Move, Move::Max> &m)
     auto pc = p & WhitePNMask;
     auto pp = p & WhitePRMask;
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         _moveWKA(~_piece[Color::White], sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _promtKA(~_piece[Color::White], sq, m);
     }
 
@@ -3721,12 +3990,10 @@ void Position::_fastWKA (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
     auto pc = p & WhitePNMask;
     auto pp = p & WhitePRMask;
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         _fastWKA(mask, sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _pfastKA(mask, sq, m);
     }
 
@@ -3749,8 +4016,7 @@ void Position::_chckWKA (const Bitboard &p, const Bitboard &em,
     auto mk = em & Effect::KA(_kingSB, _ocupd);
     auto mu = mk | (Effect::OC(_kingSB) & em );
 
-    while (pc) {
-        auto sq  = pc.pick();
+    for (auto sq : pc) {
         auto ef  = Effect::KA(sq, _ocupd);
         auto en  = ef & WhitePNMask & mk;   // np -> np
              ef &= WhitePRMask;
@@ -3760,8 +4026,7 @@ void Position::_chckWKA (const Bitboard &p, const Bitboard &em,
         _cacheMove(eo, sq);
         _promtMove(ep, sq, m);
     }
-    while (pp) {
-        auto sq  = pp.pick();
+    for (auto sq : pp) {
         auto ef  = Effect::KA(sq, _ocupd);
         auto eo  = ef & mk;                 // pr -> (np | pr) without promotion
         auto ep  = ef & mu;                 // pr -> (np | pr) with promotion
@@ -3787,16 +4052,14 @@ void Position::_cfstWKA (Array<Move::Move, Move::Max> &m)
     auto mk = Effect::KA(_kingSB, _ocupd) & _empty;
     auto mu = mk | (Effect::OC(_kingSB)   & _empty);
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         auto ef = Effect::KA(sq, _ocupd);
         auto en = ef & WhitePNMask & mk;    // np -> np
         auto ep = ef & WhitePRMask & mu;    // np -> pr with promotion
         _normlMove(en, sq, m);
         _promtMove(ep, sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ep = Effect::KA(sq, _ocupd) & mu;
         _promtMove(ep, sq, m);
     }
@@ -3929,8 +4192,7 @@ int Position::_numBHI (void)
     auto pp  = _bbord[Piece::BHI] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += (Effect::HI(sq, _ocupd) & (~_piece[Color::Black])).popcnt();
     }
 
@@ -3949,8 +4211,7 @@ int Position::_numWHI (void)
     auto pp  = _bbord[Piece::WHI] & _pinnd;
     int  num = 0;
 
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         num += (Effect::HI(sq, _ocupd) & (~_piece[Color::White])).popcnt();
     }
 
@@ -3970,12 +4231,10 @@ void Position::_moveBHI (Array<Move::Move, Move::Max> &m)
     auto pc = p & BlackPNMask;
     auto pp = p & BlackPRMask;
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         _moveBHI(~_piece[Color::Black], sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _promtHI(~_piece[Color::Black], sq, m);
     }
 
@@ -3995,12 +4254,10 @@ void Position::_fastBHI (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
     auto pc = p & BlackPNMask;
     auto pp = p & BlackPRMask;
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         _fastBHI(mask, sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _pfastHI(mask, sq, m);
     }
 
@@ -4023,8 +4280,7 @@ void Position::_chckBHI (const Bitboard &p, const Bitboard &em,
     auto mh = em & Effect::HI(_kingSW, _ocupd);
     auto mr = mh | (Effect::OC(_kingSW) & em );
 
-    while (pc) {
-        auto sq  = pc.pick();
+    for (auto sq : pc) {
         auto ef  = Effect::HI(sq, _ocupd);
         auto en  = ef & BlackPNMask & mh;   // np -> np
              ef &= BlackPRMask;
@@ -4034,8 +4290,7 @@ void Position::_chckBHI (const Bitboard &p, const Bitboard &em,
         _cacheMove(eo, sq);
         _promtMove(ep, sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ef = Effect::HI(sq, _ocupd);
         auto eo = ef & mh;                  // pr -> (np | pr) without promotion
         auto ep = ef & mr;                  // pr -> (np | pr) with promotion
@@ -4061,16 +4316,14 @@ void Position::_cfstBHI (Array<Move::Move, Move::Max> &m)
     auto mh = Effect::HI(_kingSW, _ocupd) & _empty;
     auto mr = mh | (Effect::OC(_kingSW)   & _empty);
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         auto ef = Effect::HI(sq, _ocupd);
         auto en = ef & BlackPNMask & mh;    // np -> np
         auto ep = ef & BlackPRMask & mr;    // np -> pr with promotion
         _normlMove(en, sq, m);
         _promtMove(ep, sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ep = Effect::HI(sq, _ocupd) & mr;
         _promtMove(ep, sq, m);
     }
@@ -4090,12 +4343,10 @@ void Position::_moveWHI (Array<Move::Move, Move::Max> &m)
     auto pc = p & WhitePNMask;
     auto pp = p & WhitePRMask;
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         _moveWHI(~_piece[Color::White], sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _promtHI(~_piece[Color::White], sq, m);
     }
 
@@ -4115,12 +4366,10 @@ void Position::_fastWHI (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
     auto pc = p & WhitePNMask;
     auto pp = p & WhitePRMask;
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         _fastWHI(mask, sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         _pfastHI(mask, sq, m);
     }
 
@@ -4143,8 +4392,7 @@ void Position::_chckWHI (const Bitboard &p, const Bitboard &em,
     auto mh = em & Effect::HI(_kingSB, _ocupd);
     auto mr = mh | (Effect::OC(_kingSB) & em );
 
-    while (pc) {
-        auto sq  = pc.pick();
+    for (auto sq : pc) {
         auto ef  = Effect::HI(sq, _ocupd); 
         auto en  = ef & WhitePNMask & mh;   // np -> np
              ef &= WhitePRMask;
@@ -4154,8 +4402,7 @@ void Position::_chckWHI (const Bitboard &p, const Bitboard &em,
         _cacheMove(eo, sq);
         _promtMove(ep, sq, m);
     }
-    while (pp) {
-        auto sq  = pp.pick();
+    for (auto sq : pp) {
         auto ef  = Effect::HI(sq, _ocupd); 
         auto eo  = ef & mh;                 // pr -> (np | pr) without promotion
         auto ep  = ef & mr;                 // pr -> (np | pr) with promotion
@@ -4181,16 +4428,14 @@ void Position::_cfstWHI (Array<Move::Move, Move::Max> &m)
     auto mh = Effect::HI(_kingSB, _ocupd) & _empty;
     auto mr = mh | (Effect::OC(_kingSB)   & _empty);
 
-    while (pc) {
-        auto sq = pc.pick();
+    for (auto sq : pc) {
         auto ef = Effect::HI(sq, _ocupd); 
         auto en = ef & WhitePNMask & mh;    // np -> np
         auto ep = ef & WhitePRMask & mr;    // np -> pr with promotion
         _normlMove(en, sq, m);
         _promtMove(ep, sq, m);
     }
-    while (pp) {
-        auto sq = pp.pick();
+    for (auto sq : pp) {
         auto ep = Effect::HI(sq, _ocupd) & mr; 
         _promtMove(ep, sq, m);
     }
@@ -4331,8 +4576,7 @@ void Position::_discChckB (Array<Move::Move, Move::Max> &m)
 
     // BKY
     auto bky = _bbord[Piece::BKY];
-    while (bky) {
-        auto sq = bky.pick();
+    for (auto sq : bky) {
         auto ef = Effect::KB(sq, _ocupd);
         auto pc = ef & Effect::KW(_kingSW, _ocupd) & atk;
         if (! pc) {
@@ -4355,8 +4599,7 @@ void Position::_discChckB (Array<Move::Move, Move::Max> &m)
     auto mv  = [&] (const Bitboard & (*func)(Square::Square, const Bitboard&),
                     const Bitboard & (*mask)(Square::Square),
                           Bitboard bmp                                         ) {
-        while (bmp) {
-            auto sq = bmp.pick();
+        for (auto sq : bmp) {
             auto ef = func(sq, _ocupd) & mask(sq);
             auto pc = ef & (func(_kingSW, _ocupd) & mask(_kingSW)) & atk;
             if (! pc) {
@@ -4409,8 +4652,7 @@ void Position::_discChckW (Array<Move::Move, Move::Max> &m)
 
     // WKY
     auto wky = _bbord[Piece::WKY];
-    while (wky) {
-        auto sq = wky.pick();
+    for (auto sq : wky) {
         auto ef = Effect::KW(sq, _ocupd);
         auto pc = ef & Effect::KB(_kingSB, _ocupd) & atk;
         if (! pc) {
@@ -4433,8 +4675,7 @@ void Position::_discChckW (Array<Move::Move, Move::Max> &m)
     auto mv  = [&] (const Bitboard & (*func)(Square::Square, const Bitboard&),
                     const Bitboard & (*mask)(Square::Square),
                           Bitboard bmp                                         ) {
-        while (bmp) {
-            auto sq = bmp.pick();
+        for (auto sq : bmp) {
             auto ef = func(sq, _ocupd) & mask(sq);
             auto pc = ef & (func(_kingSB, _ocupd) & mask(_kingSB)) & atk;
             if (! pc) {
@@ -4484,8 +4725,7 @@ void Position::_discCFstB (Array<Move::Move, Move::Max> &m)
 
     // BKY
     auto bky = _bbord[Piece::BKY];
-    while (bky) {
-        auto sq = bky.pick();
+    for (auto sq : bky) {
         auto ef = Effect::KB(sq, _ocupd);
         auto pc = ef & Effect::KW(_kingSW, _ocupd) & atk;
         if (! pc) {
@@ -4504,8 +4744,7 @@ void Position::_discCFstB (Array<Move::Move, Move::Max> &m)
     auto mv  = [&] (const Bitboard & (*func)(Square::Square, const Bitboard&),
                     const Bitboard & (*mask)(Square::Square),
                           Bitboard bmp                                         ) {
-        while (bmp) {
-            auto sq = bmp.pick();
+        for (auto sq : bmp) {
             auto ef = func(sq, _ocupd) & mask(sq);
             auto pc = ef & (func(_kingSW, _ocupd) & mask(_kingSW)) & atk;
             if (! pc) {
@@ -4551,8 +4790,7 @@ void Position::_discCFstW (Array<Move::Move, Move::Max> &m)
 
     // WKY
     auto wky = _bbord[Piece::WKY];
-    while (wky) {
-        auto sq = wky.pick();
+    for (auto sq : wky) {
         auto ef = Effect::KW(sq, _ocupd);
         auto pc = ef & Effect::KB(_kingSB, _ocupd) & atk;
         if (! pc) {
@@ -4571,8 +4809,7 @@ void Position::_discCFstW (Array<Move::Move, Move::Max> &m)
     auto mv  = [&] (const Bitboard & (*func)(Square::Square, const Bitboard&),
                     const Bitboard & (*mask)(Square::Square),
                           Bitboard bmp                                         ) {
-        while (bmp) {
-            auto sq = bmp.pick();
+        for (auto sq : bmp) {
             auto ef = func(sq, _ocupd) & mask(sq);
             auto pc = ef & (func(_kingSB, _ocupd) & mask(_kingSB)) & atk;
             if (! pc) {
@@ -4621,8 +4858,7 @@ int Position::_numPinB (void)
     // number of moves
     int  num    = 0;
 
-    while (pinned) {
-        auto sq = pinned.pick();
+    for (auto sq : pinned) {
         auto dr = Direction::distantDirection(sq, _kingSB);
         auto mk = DirectionMap[dr](sq) & (~_piece[Color::Black]);
         auto pc = _board[sq];
@@ -4677,8 +4913,7 @@ int Position::_numPinW (void)
     // number of moves
     int  num    = 0;
 
-    while (pinned) {
-        auto sq = pinned.pick();
+    for (auto sq : pinned) {
         auto dr = Direction::distantDirection(sq, _kingSW);
         auto mk = DirectionMap[dr](sq) & (~_piece[Color::White]);
         auto pc = _board[sq];
@@ -4735,8 +4970,7 @@ void Position::_movePinB (Array<Move::Move, Move::Max> &m)
     auto pinnds = pinned & BlackPRMask & target;
     auto pinndn = pinned & (~pinnds);
 
-    while (pinndn) {
-        auto sq = pinndn.pick();
+    for (auto sq : pinndn) {
         auto dr = Direction::distantDirection(sq, _kingSB);
         auto mk = DirectionMap[dr](sq) & (~_piece[Color::Black]);
         auto pc = _board[sq];
@@ -4767,8 +5001,7 @@ void Position::_movePinB (Array<Move::Move, Move::Max> &m)
         }
     }
 
-    while (pinnds) {
-        auto sq = pinnds.pick();
+    for (auto sq : pinnds) {
         auto dr = Direction::distantDirection(sq, _kingSB);
         auto mk = DirectionMap[dr](sq) & (~_piece[Color::Black]);
         auto pc = _board[sq];
@@ -4815,8 +5048,7 @@ void Position::_movePinW (Array<Move::Move, Move::Max> &m)
     auto pinnds = pinned & WhitePRMask & target;
     auto pinndn = pinned & (~pinnds);
 
-    while (pinndn) {
-        auto sq = pinndn.pick();
+    for (auto sq : pinndn) {
         auto dr = Direction::distantDirection(sq, _kingSW);
         auto mk = DirectionMap[dr](sq) & (~_piece[Color::White]);
         auto pc = _board[sq];
@@ -4847,8 +5079,7 @@ void Position::_movePinW (Array<Move::Move, Move::Max> &m)
         }
     }
 
-    while (pinnds) {
-        auto sq = pinnds.pick();
+    for (auto sq : pinnds) {
         auto dr = Direction::distantDirection(sq, _kingSW);
         auto mk = DirectionMap[dr](sq) & (~_piece[Color::White]);
         auto pc = _board[sq];
@@ -4887,8 +5118,7 @@ void Position::_chckPinB (Array<Move::Move, Move::Max> &m)
     // check if any pinned piece 
     auto pinned = ~_pinnd;
 
-    while (pinned) {
-        auto sq = pinned.pick();
+    for (auto sq : pinned) {
         auto dr = Direction::distantDirection(sq, _kingSB);
         auto mk = DirectionMap[dr](sq) & (~_piece[Color::Black]);
         auto pc = _board[sq];
@@ -4936,8 +5166,7 @@ void Position::_chckPinW (Array<Move::Move, Move::Max> &m)
     // check if any pinned piece 
     auto pinned = ~_pinnd;
 
-    while (pinned) {
-        auto sq = pinned.pick();
+    for (auto sq : pinned) {
         auto dr = Direction::distantDirection(sq, _kingSW);
         auto mk = DirectionMap[dr](sq) & (~_piece[Color::White]);
         auto pc = _board[sq];
@@ -4982,8 +5211,7 @@ int Position::_numBOU (void)
 
     int  num      = 0;
     auto surround = Effect::OC(_kingSB) & (~_piece[Color::Black]);
-    while (surround) {
-        auto sq = surround.pick();
+    for (auto sq : surround) {
         if (_chkEffectW(sq)) {
             continue;
         }
@@ -5005,8 +5233,7 @@ int Position::_numBOU (const Bitboard &mask)
 
     int  num      = 0;
     auto surround = Effect::OC(_kingSB) & mask;
-    while (surround) {
-        auto sq = surround.pick();
+    for (auto sq : surround) {
         if (_chkEffectW(sq)) {
             continue;
         }
@@ -5028,8 +5255,7 @@ int Position::_numWOU (void)
 
     int  num      = 0;
     auto surround = Effect::OC(_kingSW) & (~_piece[Color::White]);
-    while (surround) {
-        auto sq = surround.pick();
+    for (auto sq : surround) {
         if (_chkEffectB(sq)) {
             continue;
         }
@@ -5051,8 +5277,7 @@ int Position::_numWOU (const Bitboard &mask)
 
     int  num      = 0;
     auto surround = Effect::OC(_kingSW) & mask;
-    while (surround) {
-        auto sq = surround.pick();
+    for (auto sq : surround) {
         if (_chkEffectB(sq)) {
             continue;
         }
@@ -5073,8 +5298,7 @@ void Position::_moveBOU (Array<Move::Move, Move::Max> &m)
 {
 
     auto surround = Effect::OC(_kingSB) & (~_piece[Color::Black]);
-    while (surround) {
-        auto sq = surround.pick();
+    for (auto sq : surround) {
         if (_chkEffectW(sq)) {
             continue;
         }
@@ -5093,8 +5317,7 @@ void Position::_moveBOU (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
 {
 
     auto surround = Effect::OC(_kingSB) & mask;
-    while (surround) {
-        auto sq = surround.pick();
+    for (auto sq : surround) {
         if (_chkEffectW(sq)) {
             continue;
         }
@@ -5113,8 +5336,7 @@ void Position::_moveWOU (Array<Move::Move, Move::Max> &m)
 {
 
     auto surround = Effect::OC(_kingSW) & (~_piece[Color::White]);
-    while (surround) {
-        auto sq = surround.pick();
+    for (auto sq : surround) {
         if (_chkEffectB(sq)) {
             continue;
         }
@@ -5133,8 +5355,7 @@ void Position::_moveWOU (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
 {
 
     auto surround = Effect::OC(_kingSW) & mask;
-    while (surround) {
-        auto sq = surround.pick();
+    for (auto sq : surround) {
         if (_chkEffectB(sq)) {
             continue;
         }
@@ -5169,8 +5390,7 @@ int Position::_numOutB (void)
 
     // move a piece to block
     auto sq = _chkDE;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         num += _numToB(mask, s);
     }
 
@@ -5207,8 +5427,7 @@ int Position::_numOutW (void)
 
     // move a piece to block
     auto sq = _chkDE;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         num += _numToW(mask, s);
     }
 
@@ -5246,8 +5465,7 @@ void Position::_getOutB (Array<Move::Move, Move::Max> &m)
 
     // move a piece to block
     auto sq = _chkDE;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         _moveToB(mask, s, m);
     }
 
@@ -5283,8 +5501,7 @@ void Position::_fstOutB (Array<Move::Move, Move::Max> &m)
 
     // move the piece to block
     auto sq = _chkDE;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         _fastToB(mask, s, m);
     }
 
@@ -5321,8 +5538,7 @@ void Position::_getOutW (Array<Move::Move, Move::Max> &m)
 
     // move a piece to block
     auto sq = _chkDE;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         _moveToW(mask, s, m);
     }
 
@@ -5358,8 +5574,7 @@ void Position::_fstOutW (Array<Move::Move, Move::Max> &m)
 
     // move the piece to block
     auto sq = _chkDE;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         _fastToW(mask, s, m);
     }
 
@@ -6043,8 +6258,7 @@ void Position::_dropBOT (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
     Piece::Piece            list[] = {Piece::GI, Piece::KI, Piece::KA, Piece::HI};
 
     auto sq = mask;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         for (auto pc : list) {
             if (_hands[Color::Black][pc] > 0) {
                 m.add(Move::drop(pc, s));
@@ -6068,8 +6282,7 @@ void Position::_dchkBOT (Array<Move::Move, Move::Max> &m)
 
     // GI
     sq = Effect::AD(_kingSW, Piece::WGI) & _empty;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         if (_hands[Color::Black][Piece::GI] > 0) {
             m.add(Move::drop(Piece::GI, s));
         }
@@ -6077,8 +6290,7 @@ void Position::_dchkBOT (Array<Move::Move, Move::Max> &m)
 
     // KI
     sq = Effect::AD(_kingSW, Piece::WKI) & _empty;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         if (_hands[Color::Black][Piece::KI] > 0) {
             m.add(Move::drop(Piece::KI, s));
         }
@@ -6086,8 +6298,7 @@ void Position::_dchkBOT (Array<Move::Move, Move::Max> &m)
 
     // KA
     sq = Effect::KA(_kingSW, _ocupd)     & _empty;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         if (_hands[Color::Black][Piece::KA] > 0) {
             m.add(Move::drop(Piece::KA, s));
         }
@@ -6095,8 +6306,7 @@ void Position::_dchkBOT (Array<Move::Move, Move::Max> &m)
 
     // KA
     sq = Effect::HI(_kingSW, _ocupd)     & _empty;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         if (_hands[Color::Black][Piece::HI] > 0) {
             m.add(Move::drop(Piece::HI, s));
         }
@@ -6117,8 +6327,7 @@ void Position::_dropWOT (const Bitboard &mask, Array<Move::Move, Move::Max> &m)
     Piece::Piece            list[] = {Piece::GI, Piece::KI, Piece::KA, Piece::HI};
 
     auto sq = mask;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         for (auto pc : list) {
             if (_hands[Color::White][pc] > 0) {
                 m.add(Move::drop(pc, s));
@@ -6142,8 +6351,7 @@ void Position::_dchkWOT (Array<Move::Move, Move::Max> &m)
 
     // GI
     sq = Effect::AD(_kingSB, Piece::BGI) & _empty;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         if (_hands[Color::White][Piece::GI] > 0) {
             m.add(Move::drop(Piece::GI, s));
         }
@@ -6151,8 +6359,7 @@ void Position::_dchkWOT (Array<Move::Move, Move::Max> &m)
 
     // KI
     sq = Effect::AD(_kingSB, Piece::BKI) & _empty;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         if (_hands[Color::White][Piece::KI] > 0) {
             m.add(Move::drop(Piece::KI, s));
         }
@@ -6160,8 +6367,7 @@ void Position::_dchkWOT (Array<Move::Move, Move::Max> &m)
 
     // KA
     sq = Effect::KA(_kingSB, _ocupd)     & _empty;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         if (_hands[Color::White][Piece::KA] > 0) {
             m.add(Move::drop(Piece::KA, s));
         }
@@ -6169,8 +6375,7 @@ void Position::_dchkWOT (Array<Move::Move, Move::Max> &m)
 
     // KA
     sq = Effect::HI(_kingSB, _ocupd)     & _empty;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         if (_hands[Color::White][Piece::HI] > 0) {
             m.add(Move::drop(Piece::HI, s));
         }
@@ -6224,8 +6429,7 @@ void Position::_moveToB (const Bitboard &mask, Square::Square dst,
 
     _allEffectB(dst);
     auto sq = _effect & mask;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         _moveBlack(s, dst, m);
     }
 
@@ -6245,8 +6449,7 @@ void Position::_fastToB (const Bitboard &mask, Square::Square dst,
 
     _allEffectB(dst);
     auto sq = _effect & mask;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         _fastBlack(s, dst, m);
     }
 
@@ -6266,8 +6469,7 @@ void Position::_moveToW (const Bitboard &mask, Square::Square dst,
 
     _allEffectW(dst);
     auto sq = _effect & mask;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         _moveWhite(s, dst, m);
     }
 
@@ -6288,8 +6490,7 @@ void Position::_fastToW (const Bitboard &mask, Square::Square dst,
 
     _allEffectW(dst);
     auto sq = _effect & mask;
-    while (sq) {
-        auto s = sq.pick();
+    for (auto s : sq) {
         _fastWhite(s, dst, m);
     }
 
@@ -6314,8 +6515,7 @@ void Position::_chckFromB (const Bitboard &mask, Square::Square from,
     switch (_board[from]) {
     case BFU:
         { auto ef = Bitboard::Square[from + Square::UWARD] & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (BFUMPromote[to]) {
                     if (! (Effect::AD(to, Piece::BKI) & _bbord[Piece::WOU])) {
                         m.add(Move::promote(from, to)); 
@@ -6334,8 +6534,7 @@ void Position::_chckFromB (const Bitboard &mask, Square::Square from,
         break;
     case BKY:
         { auto ef = Effect::KB(from, _ocupd) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (BFUMPromote[to]) {
                     if (! (Effect::AD(to, Piece::BKI) & _bbord[Piece::WOU])) {
                         m.add(Move::promote(from, to)); 
@@ -6354,8 +6553,7 @@ void Position::_chckFromB (const Bitboard &mask, Square::Square from,
         break;
     case BKE:
         { auto ef = Effect::AD(from, BKE) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (BKEMPromote[to]) {
                     if (! (Effect::AD(to, Piece::BKI) & _bbord[Piece::WOU])) {
                         m.add(Move::promote(from, to)); 
@@ -6376,8 +6574,7 @@ void Position::_chckFromB (const Bitboard &mask, Square::Square from,
         break;
     case BGI:
         { auto ef = Effect::AD(from, BGI) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (BlackCanPromote[from] || BlackCanPromote[to]) {
                     if (! (Effect::AD(to, Piece::BGI) & _bbord[Piece::WOU])) {
                         m.add(Move::move   (from, to)); 
@@ -6395,8 +6592,7 @@ void Position::_chckFromB (const Bitboard &mask, Square::Square from,
         break;
     case BKI: case BTO: case BNY: case BNK: case BNG:
         { auto ef = Effect::AD(from, BKI) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (! (Effect::AD(to, Piece::BKI) & _bbord[Piece::WOU])) {
                     m.add(Move::move(from, to)); 
                 }
@@ -6405,8 +6601,7 @@ void Position::_chckFromB (const Bitboard &mask, Square::Square from,
         break;
     case BUM:
         { auto ef = (Effect::AD(from, BUM) | Effect::KA(from, _ocupd)) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (! ((Effect::OC(to) | Effect::KA(to, _ocupd))
                                                             & _bbord[Piece::WOU])) {
                     m.add(Move::move(from, to)); 
@@ -6416,8 +6611,7 @@ void Position::_chckFromB (const Bitboard &mask, Square::Square from,
         break;
     case BRY:
         { auto ef = (Effect::AD(from, BRY) | Effect::HI(from, _ocupd)) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (! ((Effect::OC(to) | Effect::HI(to, _ocupd))
                                            & _bbord[Piece::WOU])) {
                     m.add(Move::move(from, to)); 
@@ -6427,8 +6621,7 @@ void Position::_chckFromB (const Bitboard &mask, Square::Square from,
         break;
     case BKA:
         { auto ef = Effect::KA(from, _ocupd) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (BlackCanPromote[from] || BlackCanPromote[to]) {
                     if (! (Effect::KA(to, _ocupd) & _bbord[Piece::WOU])) {
                         _m.add(Move::move   (from, to)); 
@@ -6447,8 +6640,7 @@ void Position::_chckFromB (const Bitboard &mask, Square::Square from,
         break;
     case BHI:
         { auto ef = Effect::HI(from, _ocupd) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (BlackCanPromote[from] || BlackCanPromote[to]) {
                     if (! (Effect::HI(to, _ocupd) & _bbord[Piece::WOU])) {
                         _m.add(Move::move   (from, to)); 
@@ -6491,8 +6683,7 @@ void Position::_cfstFromB (const Bitboard &mask, Square::Square from,
     switch (_board[from]) {
     case BFU:
         { auto ef = Bitboard::Square[from + Square::UWARD] & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (BlackCanPromote[to]) {
                     if (! (Effect::AD(to, Piece::BKI) & _bbord[Piece::WOU])) {
                         m.add(Move::promote(from, to)); 
@@ -6505,8 +6696,7 @@ void Position::_cfstFromB (const Bitboard &mask, Square::Square from,
         break;
     case BKY:
         { auto ef = Effect::KB(from, _ocupd) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (BFUMPromote[to]) {
                     if (! (Effect::AD(to, Piece::BKI) & _bbord[Piece::WOU])) {
                         m.add(Move::promote(from, to)); 
@@ -6525,8 +6715,7 @@ void Position::_cfstFromB (const Bitboard &mask, Square::Square from,
         break;
     case BKE:
         { auto ef = Effect::AD(from, BKE) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (BKEMPromote[to]) {
                     if (! (Effect::AD(to, Piece::BKI) & _bbord[Piece::WOU])) {
                         m.add(Move::promote(from, to)); 
@@ -6547,8 +6736,7 @@ void Position::_cfstFromB (const Bitboard &mask, Square::Square from,
         break;
     case BGI:
         { auto ef = Effect::AD(from, BGI) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (BlackCanPromote[from] || BlackCanPromote[to]) {
                     if (! (Effect::AD(to, Piece::BGI) & _bbord[Piece::WOU])) {
                         m.add(Move::move   (from, to)); 
@@ -6566,8 +6754,7 @@ void Position::_cfstFromB (const Bitboard &mask, Square::Square from,
         break;
     case BKI: case BTO: case BNY: case BNK: case BNG:
         { auto ef = Effect::AD(from, BKI) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (! (Effect::AD(to, Piece::BKI) & _bbord[Piece::WOU])) {
                     m.add(Move::move(from, to)); 
                 }
@@ -6576,8 +6763,7 @@ void Position::_cfstFromB (const Bitboard &mask, Square::Square from,
         break;
     case BUM:
         { auto ef = (Effect::AD(from, BUM) | Effect::KA(from, _ocupd)) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (! ((Effect::OC(to) | Effect::KA(to, _ocupd))
                                                             & _bbord[Piece::WOU])) {
                     m.add(Move::move(from, to)); 
@@ -6587,8 +6773,7 @@ void Position::_cfstFromB (const Bitboard &mask, Square::Square from,
         break;
     case BRY:
         { auto ef = (Effect::AD(from, BRY) | Effect::HI(from, _ocupd)) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (! ((Effect::OC(to) | Effect::HI(to, _ocupd))
                                            & _bbord[Piece::WOU])) {
                     m.add(Move::move(from, to)); 
@@ -6598,8 +6783,7 @@ void Position::_cfstFromB (const Bitboard &mask, Square::Square from,
         break;
     case BKA:
         { auto ef = Effect::KA(from, _ocupd) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (BlackCanPromote[from] || BlackCanPromote[to]) {
                     if (! ((Effect::OC(to) | Effect::KA(to, _ocupd))
                                                   & _bbord[Piece::WOU])) {
@@ -6615,8 +6799,7 @@ void Position::_cfstFromB (const Bitboard &mask, Square::Square from,
         break;
     case BHI:
         { auto ef = Effect::HI(from, _ocupd) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (BlackCanPromote[from] || BlackCanPromote[to]) {
                     if (! ((Effect::OC(to) | Effect::HI(to, _ocupd))
                                                   & _bbord[Piece::WOU])) {
@@ -6655,8 +6838,7 @@ void Position::_chckFromW (const Bitboard &mask, Square::Square from,
     switch (_board[from]) {
     case WFU:
         { auto ef = Bitboard::Square[from + Square::DWARD] & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (WFUMPromote[to]) {
                     if (! (Effect::AD(to, Piece::WKI) & _bbord[Piece::BOU])) {
                         m.add(Move::promote(from, to)); 
@@ -6675,8 +6857,7 @@ void Position::_chckFromW (const Bitboard &mask, Square::Square from,
         break;
     case WKY:
         { auto ef = Effect::KW(from, _ocupd) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (WFUMPromote[to]) {
                     if (! (Effect::AD(to, Piece::WKI) & _bbord[Piece::BOU])) {
                         m.add(Move::promote(from, to)); 
@@ -6695,8 +6876,7 @@ void Position::_chckFromW (const Bitboard &mask, Square::Square from,
         break;
     case WKE:
         { auto ef = Effect::AD(from, WKE) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (WKEMPromote[to]) {
                     if (! (Effect::AD(to, Piece::WKI) & _bbord[Piece::BOU])) {
                         m.add(Move::promote(from, to)); 
@@ -6717,8 +6897,7 @@ void Position::_chckFromW (const Bitboard &mask, Square::Square from,
         break;
     case WGI:
         { auto ef = Effect::AD(from, WGI) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (WhiteCanPromote[from] || WhiteCanPromote[to]) {
                     if (! (Effect::AD(to, Piece::WGI) & _bbord[Piece::BOU])) {
                         m.add(Move::move   (from, to)); 
@@ -6736,8 +6915,7 @@ void Position::_chckFromW (const Bitboard &mask, Square::Square from,
         break;
     case WKI: case WTO: case WNY: case WNK: case WNG:
         { auto ef = Effect::AD(from, WKI) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (! (Effect::AD(to, Piece::WKI) & _bbord[Piece::BOU])) {
                     m.add(Move::move(from, to)); 
                 }
@@ -6746,8 +6924,7 @@ void Position::_chckFromW (const Bitboard &mask, Square::Square from,
         break;
     case WUM:
         { auto ef = (Effect::AD(from, WUM) | Effect::KA(from, _ocupd)) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (! ((Effect::OC(to) | Effect::KA(to, _ocupd))
                                             & _bbord[Piece::BOU])) {
                     m.add(Move::move(from, to)); 
@@ -6757,8 +6934,7 @@ void Position::_chckFromW (const Bitboard &mask, Square::Square from,
         break;
     case WRY:
         { auto ef = (Effect::AD(from, WRY) | Effect::HI(from, _ocupd)) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (! ((Effect::OC(to) | Effect::HI(to, _ocupd))
                                             & _bbord[Piece::BOU])) {
                     m.add(Move::move(from, to)); 
@@ -6768,8 +6944,7 @@ void Position::_chckFromW (const Bitboard &mask, Square::Square from,
         break;
     case WKA:
         { auto ef = Effect::KA(from, _ocupd) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (WhiteCanPromote[from] || WhiteCanPromote[to]) {
                     if (! (Effect::KA(to, _ocupd) & _bbord[Piece::BOU])) {
                         _m.add(Move::move   (from, to)); 
@@ -6788,8 +6963,7 @@ void Position::_chckFromW (const Bitboard &mask, Square::Square from,
         break;
     case WHI:
         { auto ef = Effect::HI(from, _ocupd) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (WhiteCanPromote[from] || WhiteCanPromote[to]) {
                     if (! (Effect::HI(to, _ocupd) & _bbord[Piece::BOU])) {
                         _m.add(Move::move   (from, to)); 
@@ -6831,8 +7005,7 @@ void Position::_cfstFromW (const Bitboard &mask, Square::Square from,
     switch (_board[from]) {
     case WFU:
         { auto ef = Bitboard::Square[from + Square::DWARD] & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (WhiteCanPromote[to]) {
                     if (! (Effect::AD(to, Piece::WKI) & _bbord[Piece::BOU])) {
                         m.add(Move::promote(from, to)); 
@@ -6845,8 +7018,7 @@ void Position::_cfstFromW (const Bitboard &mask, Square::Square from,
         break;
     case WKY:
         { auto ef = Effect::KW(from, _ocupd) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (WFUMPromote[to]) {
                     if (! (Effect::AD(to, Piece::WKI) & _bbord[Piece::BOU])) {
                         m.add(Move::promote(from, to)); 
@@ -6865,8 +7037,7 @@ void Position::_cfstFromW (const Bitboard &mask, Square::Square from,
         break;
     case WKE:
         { auto ef = Effect::AD(from, WKE) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (WKEMPromote[to]) {
                     if (! (Effect::AD(to, Piece::WKI) & _bbord[Piece::BOU])) {
                         m.add(Move::promote(from, to)); 
@@ -6887,8 +7058,7 @@ void Position::_cfstFromW (const Bitboard &mask, Square::Square from,
         break;
     case WGI:
         { auto ef = Effect::AD(from, WGI) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (WhiteCanPromote[from] || WhiteCanPromote[to]) {
                     if (! (Effect::AD(to, Piece::WGI) & _bbord[Piece::BOU])) {
                         m.add(Move::move   (from, to)); 
@@ -6906,8 +7076,7 @@ void Position::_cfstFromW (const Bitboard &mask, Square::Square from,
         break;
     case WKI: case WTO: case WNY: case WNK: case WNG:
         { auto ef = Effect::AD(from, WKI) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (! (Effect::AD(to, Piece::WKI) & _bbord[Piece::BOU])) {
                     m.add(Move::move(from, to)); 
                 }
@@ -6916,8 +7085,7 @@ void Position::_cfstFromW (const Bitboard &mask, Square::Square from,
         break;
     case WUM:
         { auto ef = (Effect::AD(from, WUM) | Effect::KA(from, _ocupd)) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (! ((Effect::OC(to) | Effect::KA(to, _ocupd))
                                             & _bbord[Piece::BOU])) {
                     m.add(Move::move(from, to)); 
@@ -6927,8 +7095,7 @@ void Position::_cfstFromW (const Bitboard &mask, Square::Square from,
         break;
     case WRY:
         { auto ef = (Effect::AD(from, WRY) | Effect::HI(from, _ocupd)) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (! ((Effect::OC(to) | Effect::HI(to, _ocupd))
                                             & _bbord[Piece::BOU])) {
                     m.add(Move::move(from, to)); 
@@ -6938,8 +7105,7 @@ void Position::_cfstFromW (const Bitboard &mask, Square::Square from,
         break;
     case WKA:
         { auto ef = Effect::KA(from, _ocupd) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (WhiteCanPromote[from] || WhiteCanPromote[to]) {
                     if (! ((Effect::OC(to) | Effect::KA(to, _ocupd))
                                                   & _bbord[Piece::BOU])) {
@@ -6955,8 +7121,7 @@ void Position::_cfstFromW (const Bitboard &mask, Square::Square from,
         break;
     case WHI:
         { auto ef = Effect::HI(from, _ocupd) & mask;
-            while (ef) {
-                auto to = ef.pick();
+            for (auto to : ef) {
                 if (WhiteCanPromote[from] || WhiteCanPromote[to]) {
                     if (! ((Effect::OC(to) | Effect::HI(to, _ocupd))
                                                   & _bbord[Piece::BOU])) {
@@ -6990,8 +7155,7 @@ bool Position::_chkEffectB (Square::Square sq)
 
     // check adjacent pieces
     auto ad = Effect::DU(sq) & _piece[Color::Black];
-    while (ad) {
-        auto s = ad.pick();
+    for (auto s : ad) {
         if ((Effect::AD(s, _board[s]) & Bitboard::Square[sq])) {
             return true;
         }
@@ -7036,8 +7200,7 @@ bool Position::_chkEffectW (Square::Square sq)
 
     // check adjacent pieces
     auto ad = Effect::DU(sq) & _piece[Color::White];
-    while (ad) {
-        auto s = ad.pick();
+    for (auto s : ad) {
         if ((Effect::AD(s, _board[s]) & Bitboard::Square[sq])) {
             return true;
         }
@@ -7082,8 +7245,7 @@ void Position::_allEffectB (Square::Square sq)
 
     // check adjacent pieces
     auto ad = Effect::DU(sq) & _piece[Color::Black];
-    while (ad) {
-        auto s   = ad.pick();
+    for (auto s : ad) {
         if ((Effect::AD(s, _board[s]) & Bitboard::Square[sq])) {
             _effect |= Bitboard::Square[s];
         }
@@ -7123,8 +7285,7 @@ void Position::_allEffectW (Square::Square sq)
 
     // check adjacent pieces
     auto ad = Effect::DU(sq) & _piece[Color::White];
-    while (ad) {
-        auto s   = ad.pick();
+    for (auto s : ad) {
         if ((Effect::AD(s, _board[s]) & Bitboard::Square[sq])) {
             _effect |= Bitboard::Square[s];
         }
@@ -7186,8 +7347,7 @@ void Position::_makePinB (void)
 
     // for attacking KY
     auto mky = _bbord[aky] & (~_chckp);
-    while (mky) {
-        auto sq  = mky.pick();
+    for (auto sq : mky) {
         auto yk  = Effect::KW(sq, _ocupd);
         auto yo  = Effect::KB(guard, _ocupd);
         _pinnd  ^= (yk & yo & ify);
@@ -7195,8 +7355,7 @@ void Position::_makePinB (void)
 
     // for attacking KA and UM
     auto mka = (_bbord[aka] | _bbord[aum]) & (~_chckp);
-    while (mka) {
-        auto sq  = mka.pick();
+    for (auto sq : mka) {
         auto kk  = Effect::KA(sq,    _ocupd);
         auto ko  = Effect::KA(guard, _ocupd);
         _pinnd  ^= ((kk & Effect::RS(sq)) & (ko & Effect::RS(guard)));
@@ -7205,8 +7364,7 @@ void Position::_makePinB (void)
 
     // for attacking HI and RY
     auto mhi = (_bbord[ahi] | _bbord[ary]) & (~_chckp);
-    while (mhi) {
-        auto sq  = mhi.pick();
+    for (auto sq : mhi) {
         auto hh  = Effect::HI(sq,    _ocupd);
         auto ho  = Effect::HI(guard, _ocupd);
         _pinnd  ^= ((hh & Effect::HH(sq)) & (ho & Effect::HH(guard)));
@@ -7251,8 +7409,7 @@ void Position::_makePinW (void)
 
     // for attacking KY
     auto mky = _bbord[aky] & (~_chckp);
-    while (mky) {
-        auto sq  = mky.pick();
+    for (auto sq : mky) {
         auto yk  = Effect::KB(sq, _ocupd);
         auto yo  = Effect::KW(guard, _ocupd);
         _pinnd  ^= (yk & yo & ify);
@@ -7260,8 +7417,7 @@ void Position::_makePinW (void)
 
     // for attacking KA and UM
     auto mka = (_bbord[aka] | _bbord[aum]) & (~_chckp);
-    while (mka) {
-        auto sq  = mka.pick();
+    for (auto sq : mka) {
         auto kk  = Effect::KA(sq,    _ocupd);
         auto ko  = Effect::KA(guard, _ocupd);
         _pinnd  ^= ((kk & Effect::RS(sq)) & (ko & Effect::RS(guard)));
@@ -7270,8 +7426,7 @@ void Position::_makePinW (void)
 
     // for attacking HI and RY
     auto mhi = (_bbord[ahi] | _bbord[ary]) & (~_chckp);
-    while (mhi) {
-        auto sq  = mhi.pick();
+    for (auto sq : mhi) {
         auto hh  = Effect::HI(sq,    _ocupd);
         auto ho  = Effect::HI(guard, _ocupd);
         _pinnd  ^= ((hh & Effect::HH(sq)) & (ho & Effect::HH(guard)));
@@ -7312,8 +7467,7 @@ void Position::_makeCheckB (void)
     auto adjacent = Effect::DU(guard) & _piece[Color::White];
 
     // check by adjacent pieces
-    while (adjacent) {
-        auto sq = adjacent.pick();
+    for (auto sq : adjacent) {
         if (Effect::AD(sq, _board[sq]) & Bitboard::Square[guard]) {
             _chckp ^= Bitboard::Square[sq];
             _chkAD ^= Bitboard::Square[sq];
@@ -7402,8 +7556,7 @@ void Position::_makeCheckW (void)
     auto adjacent = Effect::DU(guard) & _piece[Color::Black];
 
     // check by adjacent pieces
-    while (adjacent) {
-        auto sq = adjacent.pick();
+    for (auto sq : adjacent) {
         if (Effect::AD(sq, _board[sq]) & Bitboard::Square[guard]) {
             _chckp ^= Bitboard::Square[sq];
             _chkAD ^= Bitboard::Square[sq];
@@ -7485,8 +7638,174 @@ void Position::_hashFull (void)
     // whole key
     _key = _keyBoard ^ _keyHands;
 
+#ifdef USE_WIDEHASHKEY
+    // secondary keys
+    _vkeyBoard = 0;
+    for (auto s : Square::all) {
+        _vkeyBoard ^= Zobrist::verifyPosition[s][_board[s]];
+    }
+    _vkeyHands = 0;
+    for (auto p : Piece::hand) {
+        _vkeyHands += (_hands[Color::Black][p] *
+                       Zobrist::verifyHands[Color::Black][p]);
+        _vkeyHands += (_hands[Color::White][p] *
+                       Zobrist::verifyHands[Color::White][p]);
+    }
+#endif
+
+#ifdef USE_SUBHASHKEY
+    // sub keys
+    _keyPawn                = _pawnKey();
+    _keyKing[Color::Black]  = _kingKey(Color::Black);
+    _keyKing[Color::White]  = _kingKey(Color::White);
+#endif
+
 }
 
+
+
+/**
+ * Calculate hash for FU
+ * @return hash key for FU on board
+ */
+Zobrist::key Position::_pawnKey (void) const
+{
+
+    Zobrist::key            key = 0;
+
+    for (auto s : _bbord[Piece::BFU]) {
+        key ^= Zobrist::position[s][Piece::BFU];
+    }
+    for (auto s : _bbord[Piece::WFU]) {
+        key ^= Zobrist::position[s][Piece::WFU];
+    }
+
+    return key;
+
+}
+
+
+
+/**
+ * Calculate hash for the pieces around OU
+ * @param c color of OU
+ * @return hash key for the squares around OU (0 without OU)
+ */
+Zobrist::key Position::_kingKey (Color::Color c) const
+{
+
+    Square::Square          k   = (c == Color::Black) ? _kingSB : _kingSW;
+    Zobrist::key            key = 0;
+
+    for (auto s : _kingArea[k]) {
+        key ^= Zobrist::position[s][_board[s]];
+    }
+
+    return key;
+
+}
+
+
+
+#ifdef USE_ATTACKCOUNTMAP
+/**
+ * Count the pieces reaching to each square from scratch
+ */
+void Position::_countFull (void)
+{
+
+    memset(_count, 0, sizeof(_count));
+
+    _countBoard(_ocupd, 1);
+
+}
+
+
+
+/**
+ * Add or subtract the effect of the piece to the counts
+ * @param sq square of the piece
+ * @param pc piece (nothing is done for Piece::EMP)
+ * @param delta 1 to add or -1 to subtract
+ */
+void Position::_countPiece (Square::Square sq, Piece::Piece pc, int delta)
+{
+
+    using namespace Piece;
+
+    Bitboard                effect;
+
+    switch (pc) {
+    case EMP:
+        return;
+    case BKY:
+    case WKY:
+        effect = Effect::KY(color(pc), sq, _ocupd);
+        break;
+    case BKA:
+    case WKA:
+    case BUM:
+    case WUM:
+        effect = Effect::KA(sq, _ocupd) | Effect::AD(sq, pc);
+        break;
+    case BHI:
+    case WHI:
+    case BRY:
+    case WRY:
+        effect = Effect::HI(sq, _ocupd) | Effect::AD(sq, pc);
+        break;
+    default:
+        effect = Effect::AD(sq, pc);
+        break;
+    }
+
+    auto &                  count = _count[color(pc)];
+    for (auto s : effect) {
+        count[s] = static_cast<unsigned char>(count[s] + delta);
+    }
+
+}
+
+
+
+/**
+ * Sliding pieces of both colors reaching to the square. Their effects
+ * beyond the square change when the square is vacated or occupied.
+ * @param sq square
+ * @return bitboard of the sliding pieces
+ */
+Bitboard Position::_countRange (Square::Square sq) const
+{
+
+    using namespace Piece;
+
+    // KY moves forward, therefore, is found backward from the square
+    return (Effect::KA(sq, _ocupd) & (_bbord[BKA] | _bbord[WKA] |
+                                      _bbord[BUM] | _bbord[WUM]  ))
+         | (Effect::HI(sq, _ocupd) & (_bbord[BHI] | _bbord[WHI] |
+                                      _bbord[BRY] | _bbord[WRY]  ))
+         | (Effect::KY(Color::White, sq, _ocupd) & _bbord[BKY])
+         | (Effect::KY(Color::Black, sq, _ocupd) & _bbord[WKY]);
+
+}
+
+
+
+/**
+ * Add or subtract the effects of the pieces to the counts
+ * @param bb squares of the pieces
+ * @param delta 1 to add or -1 to subtract
+ */
+void Position::_countBoard (const Bitboard &bb, int delta)
+{
+
+    for (auto sq : bb) {
+        _countPiece(sq, _board[sq], delta);
+    }
+
+}
+#endif
+
 /* ------------------------------------------------------------------------- */
 
 // end namespace 'game'
@@ -49,6 +49,7 @@
 #include <Square.h>
 #include <Bitboard.h>
 #include <Zobrist.h>
+#include <Hand.h>
 #include <Evaluation.h>
 #include <Move.h>
 
@@ -99,10 +100,13 @@ public:
     /// Get yourTurn in CSA game summary
     static Color::Color         myTurn     (const CSASummary &);
 
+    /// Set the distance of the squares around OU covered by hashKing()
+    static void                 kingArea   (int = 1);
+
 
 
     // Default constructor
-    Position () {}
+    Position () : _hook(nullptr), _hookArg(nullptr) {}
 
     /// Copy constructor avoiding copying context cache
     Position (const Position &);
@@ -119,6 +123,21 @@ public:
     /// Whole hash key
     Zobrist::key                hash       (void)           const;
 
+    /// Secondary hash key verifying the whole hash key
+    Zobrist::key                verifier   (void)           const;
+
+    /// Hash key for the pieces on board
+    Zobrist::key                hashBoard  (void)           const;
+
+    /// Packed pieces in the hand
+    Hand::Hand                  hand       (Color::Color)   const;
+
+    /// Hash key for the FU on board
+    Zobrist::key                hashPawn   (void)           const;
+
+    /// Hash key for the pieces around OU of the color
+    Zobrist::key                hashKing   (Color::Color)   const;
+
     /// Occupied squares
     const Bitboard &            occupied   (void)           const;
 
@@ -144,6 +163,12 @@ public:
     /// Occupied squares by color
     const Bitboard &            occupied   (Color::Color  ) const;
 
+#ifdef USE_ATTACKCOUNTMAP
+    /// Number of the colored pieces reaching to the square
+    int                         attackers  (Color::Color,
+                                            Square::Square) const;
+#endif
+
 
     /// Show the board
     void                        show       (void)           const;
@@ -175,6 +200,12 @@ public:
     /// Make a move (CSA protocol)
     Move::Move                  move       (const CSAMove    &);
 
+    /// Callback fired by the moves as soon as the new hash key is known
+    using Hook                  = void (*)(const Position &, void *);
+
+    /// Set the callback fired by the moves (nullptr to remove)
+    void                        hook       (Hook, void * = nullptr);
+
     /// Last move
     Move::Move                  lastMove   (void)           const;
 
@@ -187,6 +218,9 @@ public:
     bool                        dustyB     (const Move::Move &) const;
     bool                        dustyW     (const Move::Move &) const;
 
+    /// Check if the last move left OU of the last player in check
+    bool                        exposed    (void);
+
 
     /// Make check
     void                        makeCheck  (void);
@@ -286,6 +320,22 @@ protected:
     /// Hash for both the board and the hands
     Zobrist::key                _key;
 
+#ifdef USE_WIDEHASHKEY
+    /// Secondary hash for pieces on board
+    Zobrist::key                _vkeyBoard;
+
+    /// Secondary hash for pieces in hands
+    Zobrist::key                _vkeyHands;
+#endif
+
+#ifdef USE_SUBHASHKEY
+    /// Hash for FU on board
+    Zobrist::key                _keyPawn;
+
+    /// Hash for pieces around OU
+    Zobrist::key                _keyKing[Color::Colors];
+#endif
+
     /// Square of BOU
     Square::Square              _kingSB;
 
@@ -322,6 +372,17 @@ protected:
     /// Number of moves
     int                         _numMoves;
 
+    /// Callback fired by the moves
+    Hook                        _hook;
+
+    /// Argument to the callback
+    void *                      _hookArg;
+
+#ifdef USE_ATTACKCOUNTMAP
+    /// Number of the pieces reaching to each square
+    unsigned char               _count[Color::Colors][Square::SQVD];
+#endif
+
 
 
     ///
@@ -331,6 +392,9 @@ protected:
     /// Value of the pieces on the board
     static Evaluation::Eval     _pieceVal[Piece::Pieces];
 
+    /// Squares around OU covered by hashKing() (none for SQVD)
+    static Bitboard             _kingArea[Square::Squares];
+
     /**
         Value of the pieces in the hands
 
@@ -734,10 +798,63 @@ protected:
     /// Calculate hash
     void                        _hashFull   (void);
 
+    /// Calculate hash for FU
+    Zobrist::key                _pawnKey    (void)           const;
+
+    /// Calculate hash for the pieces around OU
+    Zobrist::key                _kingKey    (Color::Color)   const;
+
+#ifdef USE_SUBHASHKEY
+    /// Update the sub hashes for the piece put or removed
+    void                        _subKey     (Square::Square, Piece::Piece);
+#endif
+
+#ifdef USE_ATTACKCOUNTMAP
+    /// Count the pieces reaching to each square
+    void                        _countFull  (void);
+
+    /// Add or subtract the effect of the piece to the counts
+    void                        _countPiece (Square::Square, Piece::Piece, int);
+
+    /// Sliding pieces reaching to the square
+    Bitboard                    _countRange (Square::Square) const;
+
+    /// Add or subtract the effects of the pieces to the counts
+    void                        _countBoard (const Bitboard &, int);
+#endif
+
 };
 
 /* ------------------------------------------------------------------------- */
 
+
+
+/* ---------------------------- implementations ---------------------------- */
+
+#ifdef USE_SUBHASHKEY
+/**
+ * Update the sub hashes for the piece put on or removed from the square
+ * @param sq square of the board
+ * @param pc piece including EMP
+ */
+inline void Position::_subKey (Square::Square sq, Piece::Piece pc)
+{
+
+    if (pc == Piece::BFU || pc == Piece::WFU) {
+        _keyPawn                ^= Zobrist::position[sq][pc];
+    }
+    if (_kingArea[_kingSB] & sq) {
+        _keyKing[Color::Black]  ^= Zobrist::position[sq][pc];
+    }
+    if (_kingArea[_kingSW] & sq) {
+        _keyKing[Color::White]  ^= Zobrist::position[sq][pc];
+    }
+
+}
+#endif
+
+/* ------------------------------------------------------------------------- */
+
 // end namespace 'game'
 }
 
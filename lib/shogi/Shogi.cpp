@@ -67,6 +67,9 @@ void initialize (void)
     // Zobrist hashing
     Zobrist::initialize();
 
+    // area around OU for the sub hash key
+    Position::kingArea();
+
 }
 
 /* ------------------------------------------------------------------------- */
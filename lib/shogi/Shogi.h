@@ -54,6 +54,14 @@
 #include <Zobrist.h>
 #include <Position.h>
 #include <Evaluation.h>
+#include <TranspositionTable.h>
+#include <Hand.h>
+#include <HandTable.h>
+#include <EvalCache.h>
+#include <History.h>
+#include <Parameters.h>
+#include <TimeManager.h>
+#include <Search.h>
 
 
 
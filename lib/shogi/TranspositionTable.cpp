@@ -0,0 +1,675 @@
+/**
+ *****************************************************************************
+
+ @file       TranspositionTable.cpp
+
+ @brief      Transposition table implementation
+  
+ @author     Hiroki Takada (http://wwww.tsoftware.jp/)
+
+ @date       2026-10-18
+
+ @version    $Id:$
+
+
+  Copyright 2014, 2015, 2016, 2017 Hiroki Takada
+
+  This file is part of libshogi.
+
+  libshogi is free software: you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  libshogi is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with libshogi. If not, see <http://www.gnu.org/licenses/>.
+
+   
+  ----------------------------------------------------------------------------
+  RELEASE NOTE :
+
+   DATE          REV    REMARK
+  ============= ====== =======================================================
+  18th Oct 2026  0.1   Initial release
+ 
+ *****************************************************************************/ 
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <climits>
+#include <algorithm>
+
+#include <TranspositionTable.h>
+#include <Effect.h>
+
+// begin namespace 'game'
+namespace game {
+
+/* ------------------------------- parameters ------------------------------ */
+
+// Magic number of the file
+static const char           _magic[8] = {'L','I','B','S','H','O','G','I'};
+
+// Version of the file format
+static const uint32_t       _version  = 1;
+
+// Revision of the packing of the data word
+static const uint32_t       _packing  = 1;
+
+/* ------------------------------------------------------------------------- */
+
+/* ---------------------------- implementations ---------------------------- */
+
+/**
+ * Constructor
+ * @param mib size of the table in MiB
+ */
+TranspositionTable::TranspositionTable (size_t mib) :
+    _header(nullptr), _table(nullptr), _clusters(0), _mapped(0), _generation(0),
+    _shared(false)
+{
+
+    resize(mib);
+
+}
+
+
+
+/**
+ * Destructor
+ * 
+ */
+TranspositionTable::~TranspositionTable ()
+{
+
+    _release();
+
+}
+
+
+
+/**
+ * Reallocate the table in the given size and clear it
+ * @param mib size of the table in MiB
+ * @param threads number of threads clearing the table
+ */
+void TranspositionTable::resize (size_t mib, int threads)
+{
+
+    _release();
+    _allocate(mib << 20);
+    clear(threads);
+
+}
+
+
+
+/**
+ * Clear all the entries
+ * The table is split into the equal parts cleared by the threads, which
+ * also spreads the first touch of the pages over the processors running
+ * them. There is no need to clear the table between the moves of a game;
+ * newSearch() ages the entries instead.
+ * @param threads number of threads (0 for the number of processors)
+ */
+void TranspositionTable::clear (int threads)
+{
+
+    Part                    part[Threads];
+    pthread_t               th  [Threads];
+
+    if (threads <= 0) {
+        threads = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+    }
+    if (threads > Threads) {
+        threads = Threads;
+    }
+
+    // small tables are not worth the threads
+    const size_t            span = Effect::HugePage / sizeof(Cluster);
+    if (_clusters < span * 2 || threads <= 1) {
+        threads = 1;
+    }
+
+    // split on the huge page boundaries
+    size_t                  unit = (_clusters / static_cast<size_t>(threads)
+                                              + span - 1) / span * span;
+    size_t                  from = 0;
+    int                     n    = 0;
+    for (; n < threads && from < _clusters; ++n) {
+        part[n].table    = _table + from;
+        part[n].clusters = std::min(unit, _clusters - from);
+        from            += part[n].clusters;
+    }
+
+    // the calling thread takes the first part
+    int                     run  = 1;
+    for (; run < n; ++run) {
+        if (pthread_create(&th[run], nullptr, _clear, &part[run]) != 0) {
+            _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT("pthread_create()");
+            break;
+        }
+    }
+    _clear(&part[0]);
+    for (int i = run; i < n; ++i) {
+        _clear(&part[i]);
+    }
+    for (int i = 1; i < run; ++i) {
+        pthread_join(th[i], nullptr);
+    }
+
+    _generation = 0;
+    if (_header != nullptr && ! _shared) {
+        _header->generation = 0;
+    }
+
+}
+
+
+
+/**
+ * Clear a part of the clusters
+ * @param arg part of the table
+ * @return nullptr
+ */
+void * TranspositionTable::_clear (void *arg)
+{
+
+    auto                    p = static_cast<Part *>(arg);
+
+    memset(static_cast<void *>(p->table), 0, p->clusters * sizeof(Cluster));
+
+    return nullptr;
+
+}
+
+
+
+/**
+ * Start a new search
+ * The entries stored so far remain valid, but they are aged and become
+ * preferred victims of the replacement. Calling this between the moves
+ * replaces clearing the table.
+ */
+void TranspositionTable::newSearch (void)
+{
+
+    _generation = (_generation + 1) & (Generations - 1);
+    if (_header != nullptr && ! _shared) {
+        _header->generation = static_cast<uint32_t>(_generation);
+    }
+
+}
+
+
+
+/**
+ * Store the result of the search
+ * The entry for the same position is updated unless the new result is
+ * shallower and not exact. Otherwise an empty entry is taken, or the entry
+ * with the least depth, counting older generations as shallower, is
+ * replaced.
+ * @param k hash key choosing the cluster
+ * @param w secondary key verifying the entry
+ * @param m best move (Move::None keeps the move already stored)
+ * @param v value of the search
+ * @param e static evaluation
+ * @param depth remaining depth of the search
+ * @param b kind of the value
+ */
+void TranspositionTable::store (Zobrist::key k, Zobrist::key w,
+                                Move::Move m,
+                                Evaluation::Eval v, Evaluation::Eval e,
+                                int depth, Bound b)
+{
+
+    Entry *                 p      = _cluster(k)->entry;
+    Entry *                 victim = p;
+    int                     worst  = INT_MAX;
+
+    for (int i = 0; i < Ways; ++i, ++p) {
+
+        Entry               old;
+        old._check = __atomic_load_n(&p->_check, __ATOMIC_RELAXED);
+        old._data  = __atomic_load_n(&p->_data , __ATOMIC_RELAXED);
+
+        // empty entry
+        if (old._data == 0) {
+            victim = p;
+            break;
+        }
+
+        // the same position
+        if ((old._check ^ old._data) == w) {
+            if (b != Exact && depth + 4 <= old.depth() &&
+                old.generation() == _generation) {
+                return;
+            }
+            if (m == Move::None) {
+                m = old.move();
+            }
+            victim = p;
+            break;
+        }
+
+        // the shallowest and oldest entry
+        int age   = (_generation - old.generation()) & (Generations - 1);
+        int score = old.depth() - 8 * age;
+        if (score < worst) {
+            worst  = score;
+            victim = p;
+        }
+
+    }
+
+    uint64_t                d =
+          static_cast<uint64_t>(m & Move::MoveMask)
+        | static_cast<uint64_t>(static_cast<uint16_t>(v))      << 16
+        | static_cast<uint64_t>(static_cast<uint16_t>(e))      << 32
+        | static_cast<uint64_t>(static_cast<uint8_t> (depth))  << 48
+        | static_cast<uint64_t>(b)                             << 56
+        | static_cast<uint64_t>(_generation)                   << 58;
+
+    __atomic_store_n(&victim->_check, w ^ d, __ATOMIC_RELAXED);
+    __atomic_store_n(&victim->_data ,     d, __ATOMIC_RELAXED);
+
+}
+
+
+
+/**
+ * Permille of the entries used in the current generation
+ * Only the first clusters are sampled, so this is cheap enough to be
+ * reported during the search.
+ * @return permille of the entries
+ */
+int TranspositionTable::hashfull (void) const
+{
+
+    const size_t            n     = std::min(static_cast<size_t>(Samples),
+                                             _clusters);
+    size_t                  count = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        for (const auto &e : _table[i].entry) {
+            uint64_t d = __atomic_load_n(&e._data, __ATOMIC_RELAXED);
+            if (d != 0 &&
+                static_cast<int>(d >> 58) == _generation) {
+                ++count;
+            }
+        }
+    }
+
+    return static_cast<int>(count * 1000 / (n * Ways));
+
+}
+
+
+
+/**
+ * Map the table to a file keeping the entries across the runs
+ * The entries in the file are taken over when its header matches with
+ * this build of the library, otherwise the file is truncated and the
+ * table starts empty. The file is locked while the process maps it, so
+ * two processes do not share a file by accident. The anonymous region
+ * allocated so far is released.
+ * @param path path to the file
+ * @param mib size of the table in MiB (0 takes the size of the file)
+ * @return true if the entries in the file are taken over
+ */
+bool TranspositionTable::open (const char *path, size_t mib)
+{
+
+    int                     fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT("open()");
+        throw TranspositionTableException();
+    }
+
+    // the lock is released when the last descriptor of the file is closed,
+    // the mapping keeps it open
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT("flock()");
+        ::close(fd);
+        throw TranspositionTableException();
+    }
+
+    bool                    reuse;
+    try {
+        reuse = _map(fd, mib);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+
+    return reuse;
+
+}
+
+
+
+/**
+ * Map the table to a shared memory object of the given name
+ * The first process creates the object in the given size, and the others
+ * attach to it in the size it already has. The object is locked only
+ * while it is being mapped; the processes probe and store concurrently
+ * afterwards. Each process keeps its own generation, which starts from
+ * the one in the header and is never written back. An object of another
+ * build is not reformatted, as the others may be using it. The object
+ * remains until unshare() removes it.
+ * @param name name of the object beginning with a slash
+ * @param mib size of the table in MiB (0 for the default size)
+ * @return true if the entries in the object are taken over
+ */
+bool TranspositionTable::share (const char *name, size_t mib)
+{
+
+    int                     fd = shm_open(name, O_RDWR | O_CREAT, 0600);
+    if (fd < 0) {
+        _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT("shm_open()");
+        throw TranspositionTableException();
+    }
+
+    // the processes starting at once create the object only once
+    struct stat             st;
+    if (flock(fd, LOCK_EX) != 0 || fstat(fd, &st) != 0) {
+        _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT("flock()");
+        ::close(fd);
+        throw TranspositionTableException();
+    }
+
+    // never resize nor reformat the object others may be using
+    Header                  head;
+    if (st.st_size != 0 &&
+        (static_cast<size_t>(st.st_size) < HeaderSize ||
+         pread(fd, &head, sizeof(head), 0) !=
+                                        static_cast<ssize_t>(sizeof(head)) ||
+         ! _match(head) ||
+         static_cast<size_t>(st.st_size) !=
+                            HeaderSize + head.clusters * sizeof(Cluster))) {
+        flock(fd, LOCK_UN);
+        ::close(fd);
+        throw TranspositionTableException();
+    }
+
+    bool                    reuse;
+    try {
+        reuse = _map(fd, st.st_size == 0 ? mib : 0);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    flock(fd, LOCK_UN);
+    ::close(fd);
+    _shared = true;
+
+    return reuse;
+
+}
+
+
+
+/**
+ * Remove the shared memory object of the given name
+ * The processes mapping the object keep using it until they release it.
+ * @param name name of the object
+ */
+void TranspositionTable::unshare (const char *name)
+{
+
+    if (shm_unlink(name) != 0) {
+        _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT("shm_unlink()");
+    }
+
+}
+
+
+
+/**
+ * Write the entries back to the file
+ * Nothing is done on the anonymous memory.
+ */
+void TranspositionTable::sync (void)
+{
+
+    if (_header == nullptr) {
+        return;
+    }
+
+    if (! _shared) {
+        _header->generation = static_cast<uint32_t>(_generation);
+    }
+    if (msync(_header, _mapped, MS_SYNC) != 0) {
+        _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT("msync()");
+    }
+
+}
+
+
+
+/**
+ * Map the table to a file descriptor
+ * @param fd file descriptor opened for reading and writing
+ * @param mib size of the table in MiB (0 takes the size of the file)
+ * @return true if the entries in the file are taken over
+ */
+bool TranspositionTable::_map (int fd, size_t mib)
+{
+
+    struct stat             st;
+    if (fstat(fd, &st) != 0) {
+        _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT("fstat()");
+        throw TranspositionTableException();
+    }
+
+    // check the header left in the file
+    Header                  head;
+    bool                    reuse = false;
+    if (static_cast<size_t>(st.st_size) >= HeaderSize &&
+        pread(fd, &head, sizeof(head), 0) ==
+                                        static_cast<ssize_t>(sizeof(head))) {
+        reuse = _match(head) &&
+                static_cast<size_t>(st.st_size) ==
+                            HeaderSize + head.clusters * sizeof(Cluster) &&
+                (mib == 0 ||
+                 head.clusters == (mib << 20) / sizeof(Cluster));
+    }
+
+    size_t                  clusters;
+    if (reuse) {
+        clusters = static_cast<size_t>(head.clusters);
+    } else {
+        clusters = ((mib == 0 ? Default : mib) << 20) / sizeof(Cluster);
+        if (clusters == 0) {
+            throw TranspositionTableException();
+        }
+        // truncating to zero first leaves the whole file zero filled
+        if (ftruncate(fd, 0) != 0 ||
+            ftruncate(fd, static_cast<off_t>(HeaderSize +
+                                         clusters * sizeof(Cluster))) != 0) {
+            _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT("ftruncate()");
+            throw TranspositionTableException();
+        }
+    }
+
+    const size_t            span = HeaderSize + clusters * sizeof(Cluster);
+    void *                  area = mmap(nullptr, span,
+                                        PROT_READ | PROT_WRITE,
+                                        MAP_SHARED, fd, 0);
+    if (area == MAP_FAILED) {
+        _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT("mmap()");
+        throw TranspositionTableException();
+    }
+
+    _release();
+
+    _header   = static_cast<Header *>(area);
+    _table    = reinterpret_cast<Cluster *>(
+                            static_cast<char *>(area) + HeaderSize);
+    _clusters = clusters;
+    _mapped   = span;
+
+    if (reuse) {
+        _generation = static_cast<int>(_header->generation)
+                                                    & (Generations - 1);
+    } else {
+        _format(*_header, clusters);
+        _generation = 0;
+    }
+
+    return reuse;
+
+}
+
+
+
+/**
+ * Check if the header matches with this build
+ * @param h header read from the file
+ * @return true if the entries can be taken over
+ */
+bool TranspositionTable::_match (const Header &h)
+{
+
+    Header                  mine;
+    _format(mine, static_cast<size_t>(h.clusters));
+
+    return memcmp(h.magic, mine.magic, sizeof(mine.magic)) == 0 &&
+           h.version  == mine.version  &&
+           h.layout   == mine.layout   &&
+           h.key      == mine.key      &&
+           h.seed     == mine.seed     &&
+           h.sample   == mine.sample   &&
+           h.clusters != 0;
+
+}
+
+
+
+/**
+ * Fill the header for this build
+ * The layout covers the size of the entry, the number of the ways and the
+ * packing of the data word. The sample is one of the Zobrist keys, which
+ * catches a change of the generator with the same seed.
+ * @param h header to be filled
+ * @param clusters number of clusters
+ */
+void TranspositionTable::_format (Header &h, size_t clusters)
+{
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, _magic, sizeof(h.magic));
+    h.version    = _version;
+    h.layout     = static_cast<uint32_t>(sizeof(Entry))
+                 | static_cast<uint32_t>(Ways) << 8
+                 | _packing                    << 16;
+#ifdef USE_WIDEHASHKEY
+    h.key        = 128;
+#else
+    h.key        = 64;
+#endif
+    h.generation = 0;
+    h.seed       = Zobrist::Seed;
+    h.sample     = Zobrist::position[Square::SQ99][Piece::BFU];
+    h.clusters   = clusters;
+
+}
+
+
+
+/**
+ * Allocate the region for the table
+ * The region is aligned to the huge page boundary and advised to be backed
+ * by transparent huge pages, which saves TLB misses on random probes.
+ * @param bytes size of the table in bytes
+ */
+void TranspositionTable::_allocate (size_t bytes)
+{
+
+    _clusters = bytes / sizeof(Cluster);
+    if (_clusters == 0) {
+        throw TranspositionTableException();
+    }
+
+    const size_t            page = Effect::HugePage;
+    const size_t            span = (size() + page - 1) & ~(page - 1);
+
+    // map one extra huge page to align the region to the page boundary
+    void *                  area = mmap(nullptr, span + page,
+                                        PROT_READ | PROT_WRITE,
+                                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    // fall back on the heap when the kernel refuses the mapping
+    if (area == MAP_FAILED) {
+        _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT("mmap()");
+        void *              heap;
+        if (posix_memalign(&heap, Line, size()) != 0) {
+            _clusters = 0;
+            throw TranspositionTableException();
+        }
+        _table  = static_cast<Cluster *>(heap);
+        _mapped = 0;
+        return;
+    }
+
+    // trim the both ends of the mapping
+    uintptr_t               head = reinterpret_cast<uintptr_t>(area);
+    uintptr_t               base = (head + page - 1) & ~(page - 1);
+    if (base > head) {
+        munmap(area, base - head);
+    }
+    munmap(reinterpret_cast<void *>(base + span), page - (base - head));
+
+    _table  = reinterpret_cast<Cluster *>(base);
+    _mapped = span;
+
+    // transparent huge pages
+    if (madvise(_table, _mapped, MADV_HUGEPAGE) != 0) {
+        _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT("madvise()");
+    }
+
+}
+
+
+
+/**
+ * Release the region
+ * 
+ */
+void TranspositionTable::_release (void)
+{
+
+    if (_table == nullptr) {
+        return;
+    }
+
+    if (_header != nullptr) {
+        munmap(_header, _mapped);
+    } else if (_mapped != 0) {
+        munmap(_table, _mapped);
+    } else {
+        free(_table);
+    }
+
+    _header   = nullptr;
+    _table    = nullptr;
+    _clusters = 0;
+    _mapped   = 0;
+    _shared   = false;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+// end namespace 'game'
+}
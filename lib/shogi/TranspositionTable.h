@@ -0,0 +1,486 @@
+/**
+ *****************************************************************************
+
+ @file       TranspositionTable.h
+
+ @brief      Transposition table definitions
+  
+ @author     Hiroki Takada (http://wwww.tsoftware.jp/)
+
+ @date       2026-10-18
+
+ @version    $Id:$
+
+
+  Copyright 2014, 2015, 2016, 2017 Hiroki Takada
+
+  This file is part of libshogi.
+
+  libshogi is free software: you can redistribute it and/or modify it under
+  the terms of the GNU Lesser General Public License as published by the
+  Free Software Foundation, either version 3 of the License, or (at your
+  option) any later version.
+
+  libshogi is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+  License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with libshogi. If not, see <http://www.gnu.org/licenses/>.
+
+   
+  ----------------------------------------------------------------------------
+  RELEASE NOTE :
+
+   DATE          REV    REMARK
+  ============= ====== =======================================================
+  18th Oct 2026  0.1   Initial release
+ 
+ *****************************************************************************/ 
+
+#ifndef _GAME_TRANSPOSITIONTABLE_H
+#define _GAME_TRANSPOSITIONTABLE_H
+
+#include <Common.h>
+
+#include <Zobrist.h>
+#include <Evaluation.h>
+#include <Move.h>
+
+// begin namespace 'game'
+namespace game {
+
+/* --------------------------- macro declaration --------------------------- */
+#ifdef  _GAME_TRANSPOSITIONTABLE_DEBUG
+#define _GAME_TRANSPOSITIONTABLE_CHECK(x) { assert ( (x) ); }
+#define _GAME_TRANSPOSITIONTABLE_DEBUG_ERROR_STRING_MAX 256
+#define _GAME_TRANSPOSITIONTABLE_DEBUG_OUT(fmt, args...)  { \
+            fprintf(stderr, "GAME_TRANSPOSITIONTABLE_DEBUG     : " fmt, \
+                                                                ## args); \
+        }
+#define _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT(x) { \
+            char errorString_[_GAME_TRANSPOSITIONTABLE_DEBUG_ERROR_STRING_MAX]; \
+            sprintf(errorString_, "%s - %s - %d", (x) , __FILE__, __LINE__); \
+            perror(errorString_); \
+        }
+#else
+#define _GAME_TRANSPOSITIONTABLE_CHECK(x)
+#define _GAME_TRANSPOSITIONTABLE_DEBUG_OUT(fmt, args...)
+#define _GAME_TRANSPOSITIONTABLE_DEBUG_FUNCTION_RESULT(x)
+#endif
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ------------------ transposition table exceptions ----------------------- */
+class TranspositionTableException {};
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ----------------------- TranspositionTable class ------------------------ */
+
+/**
+ *  Transposition table shared by search threads
+ *
+ *  The table is an array of 64-byte clusters, each of which holds Ways
+ *  entries and fits in a cache line. An entry is a pair of 64-bit words;
+ *  the data and the hash key XORed with the data. Threads read and write
+ *  the entries without locks, and a probe verifies the key by XORing the
+ *  two words again. An entry torn by racing writers fails the verification
+ *  and is just taken as a miss (lockless hashing by Hyatt and Mann).
+ *  The probes and the stores can also take a secondary key, such as
+ *  Position::verifier(), to verify the entries in place of the key
+ *  choosing the cluster. This makes the key effectively 64 bits plus the
+ *  bits of the index long without growing the entries.
+ *
+ *  open() maps the table to a file instead of the anonymous memory. The
+ *  file starts with a header recording the format of the file, the key
+ *  (Zobrist seed and whether the secondary key is used) and the layout
+ *  of the entries. The entries are taken over by the next run only when
+ *  all of them match, so a long analysis can resume after a crash.
+ *  share() maps the same layout to a POSIX shared memory object, which
+ *  lets the engine processes on a host share one table. The entries are
+ *  lockless in any case, so the processes need no further coordination.
+ *
+ *  The data word is packed as the followings;
+ *
+ *   MSB                                                         LSB
+ *   63      58 57 56 55      48 47         32 31         16 15       0
+ *  +----------+-----+----------+-------------+-------------+----------+
+ *  |generation|bound|  depth   |  static eval|    value    |   move   |
+ *  +----------+-----+----------+-------------+-------------+----------+
+ *
+ */
+class TranspositionTable
+{
+
+public:
+
+    /// Kind of the value stored
+    enum Bound : int {
+
+        /// No bound (only the move and the static evaluation)
+        None    = 0,
+
+        /// Upper bound (fail-low)
+        Upper   = 1,
+
+        /// Lower bound (fail-high)
+        Lower   = 2,
+
+        /// Exact value
+        Exact   = Upper | Lower
+
+    };
+
+    /// Entry of the table
+    class Entry
+    {
+
+    public:
+
+        /// Best move (or refutation)
+        Move::Move          move       (void) const {
+                                return static_cast<Move::Move>(
+                                            _data & Move::MoveMask);
+                            }
+
+        /// Value of the search
+        Evaluation::Eval    value      (void) const {
+                                return static_cast<int16_t>(_data >> 16);
+                            }
+
+        /// Static evaluation
+        Evaluation::Eval    eval       (void) const {
+                                return static_cast<int16_t>(_data >> 32);
+                            }
+
+        /// Remaining depth of the search
+        int                 depth      (void) const {
+                                return static_cast<int8_t> (_data >> 48);
+                            }
+
+        /// Kind of the value
+        Bound               bound      (void) const {
+                                return static_cast<Bound>((_data >> 56) & 3);
+                            }
+
+        /// Generation when the entry was stored
+        int                 generation (void) const {
+                                return static_cast<int>  (_data >> 58);
+                            }
+
+    private:
+
+        friend class TranspositionTable;
+
+        /// Hash key XORed with the data
+        uint64_t            _check;
+
+        /// Packed data
+        uint64_t            _data;
+
+    };
+
+    /// Number of entries in a cluster
+    static constexpr int    Ways        = 4;
+
+    /// Number of generations distinguished
+    static constexpr int    Generations = 64;
+
+    /// Size of a cluster (a cache line)
+    static constexpr size_t Line        = 64;
+
+    /// Default size of the table in MiB
+    static constexpr size_t Default     = 256;
+
+    /// Number of clusters sampled by hashfull()
+    static constexpr size_t Samples     = 1000;
+
+    /// Maximum number of threads clearing the table
+    static constexpr int    Threads     = 64;
+
+    /// Size of the header of the file
+    static constexpr size_t HeaderSize  = 4096;
+
+
+
+    /// Constructor takes the size in MiB
+    TranspositionTable (size_t = Default);
+
+    /// Destructor
+    ~TranspositionTable ();
+
+    /// Reallocate the table in the given size in MiB
+    void                    resize     (size_t, int = 0);
+
+    /// Clear all the entries with the given number of threads
+    void                    clear      (int = 0);
+
+    /// Start a new search (age the entries stored so far)
+    void                    newSearch  (void);
+
+    /// Look up the position
+    bool                    probe      (Zobrist::key, Entry &)      const;
+
+    /// Look up the position verified by the secondary key
+    bool                    probe      (Zobrist::key, Zobrist::key,
+                                        Entry &)                    const;
+
+    /// Store the result of the search
+    void                    store      (Zobrist::key, Move::Move,
+                                        Evaluation::Eval, Evaluation::Eval,
+                                        int, Bound);
+
+    /// Store the result of the search with the secondary key
+    void                    store      (Zobrist::key, Zobrist::key,
+                                        Move::Move,
+                                        Evaluation::Eval, Evaluation::Eval,
+                                        int, Bound);
+
+    /// Prefetch the cluster for the position
+    void                    prefetch   (Zobrist::key)               const;
+
+    /// Number of clusters
+    size_t                  clusters   (void)                       const;
+
+    /// Size of the table in bytes
+    size_t                  size       (void)                       const;
+
+    /// Current generation
+    int                     generation (void)                       const;
+
+    /// Permille of the entries used in the current generation
+    int                     hashfull   (void)                       const;
+
+    /// Map the table to a file keeping the entries across the runs
+    bool                    open       (const char *, size_t = 0);
+
+    /// Write the entries back to the file
+    void                    sync       (void);
+
+    /// Map the table to a shared memory object of the given name
+    bool                    share      (const char *, size_t = 0);
+
+    /// Remove the shared memory object of the given name
+    static void             unshare    (const char *);
+
+private:
+
+    /// Header of the file
+    struct Header {
+        char                magic[8];
+        uint32_t            version;
+        uint32_t            layout;
+        uint32_t            key;
+        uint32_t            generation;
+        uint64_t            seed;
+        uint64_t            sample;
+        uint64_t            clusters;
+    };
+
+    /// Cluster of the entries (a cache line)
+    struct alignas(Line) Cluster {
+        Entry               entry[Ways];
+    };
+
+    /// Part of the table cleared by a thread
+    struct Part {
+        Cluster *           table;
+        size_t              clusters;
+    };
+
+    /// Cluster for the key
+    Cluster *               _cluster   (Zobrist::key)               const;
+
+    /// Allocate the region for the table
+    void                    _allocate  (size_t);
+
+    /// Map the table to a file descriptor
+    bool                    _map       (int, size_t);
+
+    /// Check if the header matches with this build
+    static bool             _match     (const Header &);
+
+    /// Fill the header for this build
+    static void             _format    (Header &, size_t);
+
+    /// Release the region
+    void                    _release   (void);
+
+    /// Clear a part of the clusters (thread function)
+    static void *           _clear     (void *);
+
+    /// void copy constructor
+    TranspositionTable (const TranspositionTable &);
+
+    /// void copy
+    TranspositionTable &    operator=  (const TranspositionTable &);
+
+    /// Header of the file (nullptr on the anonymous memory)
+    Header *                _header;
+
+    /// Clusters
+    Cluster *               _table;
+
+    /// Number of clusters
+    size_t                  _clusters;
+
+    /// Size of the region allocated
+    size_t                  _mapped;
+
+    /// Current generation
+    int                     _generation;
+
+    /// Flag telling the mapping is shared by the processes
+    bool                    _shared;
+
+};
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* ---------------------------- implementations ---------------------------- */
+
+/**
+ * Cluster for the key
+ * The high bits of the key scaled by the number of clusters choose the
+ * cluster, so the table does not have to be a power of two in size.
+ * @param k hash key
+ * @return cluster
+ */
+inline TranspositionTable::Cluster *
+TranspositionTable::_cluster (Zobrist::key k) const
+{
+
+    return _table + static_cast<size_t>(
+            (static_cast<unsigned __int128>(k) * _clusters) >> 64);
+
+}
+
+
+
+/**
+ * Look up the position
+ * @param k hash key
+ * @param e entry to be filled when the position is found
+ * @return true if the position is found
+ */
+inline bool TranspositionTable::probe (Zobrist::key k, Entry &e) const
+{
+
+    return probe(k, k, e);
+
+}
+
+
+
+/**
+ * Look up the position verified by the secondary key
+ * @param k hash key choosing the cluster
+ * @param v secondary key verifying the entry
+ * @param e entry to be filled when the position is found
+ * @return true if the position is found
+ */
+inline bool TranspositionTable::probe (Zobrist::key k, Zobrist::key v,
+                                       Entry &e) const
+{
+
+    const Entry *           p = _cluster(k)->entry;
+
+    for (int i = 0; i < Ways; ++i, ++p) {
+        // read each word once, the writers may be racing with us
+        uint64_t c = __atomic_load_n(&p->_check, __ATOMIC_RELAXED);
+        uint64_t d = __atomic_load_n(&p->_data , __ATOMIC_RELAXED);
+        if ((c ^ d) == v && d != 0) {
+            e._check = c;
+            e._data  = d;
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+
+
+/**
+ * Store the result of the search
+ * @param k hash key
+ * @param m best move (Move::None keeps the move already stored)
+ * @param v value of the search
+ * @param e static evaluation
+ * @param depth remaining depth of the search
+ * @param b kind of the value
+ */
+inline void TranspositionTable::store (Zobrist::key k, Move::Move m,
+                                       Evaluation::Eval v, Evaluation::Eval e,
+                                       int depth, Bound b)
+{
+
+    store(k, k, m, v, e, depth, b);
+
+}
+
+
+
+/**
+ * Prefetch the cluster for the position
+ * @param k hash key
+ */
+inline void TranspositionTable::prefetch (Zobrist::key k) const
+{
+
+    __builtin_prefetch(_cluster(k));
+
+}
+
+
+
+/**
+ * Number of clusters
+ * @return number of clusters
+ */
+inline size_t TranspositionTable::clusters (void) const
+{
+
+    return _clusters;
+
+}
+
+
+
+/**
+ * Size of the table in bytes
+ * @return size of the table
+ */
+inline size_t TranspositionTable::size (void) const
+{
+
+    return _clusters * sizeof(Cluster);
+
+}
+
+
+
+/**
+ * Current generation
+ * @return generation
+ */
+inline int TranspositionTable::generation (void) const
+{
+
+    return _generation;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+// end namespace 'game'
+}
+
+#endif
@@ -39,6 +39,8 @@
  
  *****************************************************************************/ 
 
+#include <algorithm>
+
 #include <Zobrist.h>
 #include <Utility.h>
 
@@ -47,32 +49,88 @@ namespace game {
 
 /* ---------------------------- global variables --------------------------- */
 
-// Random seed
-static const int            _seed = 20160331;
-
 // Tables for random numbers to hash pieces on the board
 Zobrist::key                Zobrist::position[Square::Squares][Piece::Pieces ];
 
 // Tables for random numbers to hash pieces in the hand 
 Zobrist::key                Zobrist::hands   [Color ::Colors ][Piece::Variety];
 
+// Independent tables for the secondary key
+Zobrist::key                Zobrist::verifyPosition
+                                             [Square::Squares][Piece::Pieces ];
+Zobrist::key                Zobrist::verifyHands
+                                             [Color ::Colors ][Piece::Variety];
+
 /* ------------------------------------------------------------------------- */
 
 
 
 /* ---------------------------- implementations ---------------------------- */
 
+// Types of the tables
+using _Board = Zobrist::key[Square::Squares][Piece::Pieces ];
+using _Hands = Zobrist::key[Color ::Colors ][Piece::Variety];
 
 /**
- * The conversion from uniqueRandom() to key
- * @parm d a return from uniqueRandom()
- * @return key
- *
+ * Fill the tables with the random numbers
+ * @param state state of the random number stream
+ * @param position table for the pieces on the board
+ * @param hands table for the pieces in the hand
  */
-static Zobrist::key _conv(uint64_t d)
+static void _fill (uint64_t &state, _Board &position, _Hands &hands)
 {
 
-    return static_cast<Zobrist::key>(d);
+    for (auto sq : Square::all) {
+        for (auto p : Piece::all) {
+            do {
+                position[sq][p] = utility::splitmix(state);
+            } while (position[sq][p] == 0);
+        }
+        position[sq][Piece::EMP] = 0;
+    }
+
+    for (auto c : Color::all) {
+        for (auto p : Piece::hand) {
+            do {
+                hands[c][p]     = utility::splitmix(state);
+            } while (hands[c][p] == 0);
+        }
+        hands[c][Piece::EMP]     = 0;
+    }
+
+}
+
+
+
+/**
+ * Check if the random numbers in the tables are not duplicated
+ * @param position table for the pieces on the board
+ * @param hands table for the pieces in the hand
+ * @return true if all the numbers are unique
+ */
+static bool _unique (const _Board &position, const _Hands &hands)
+{
+
+    constexpr size_t        n = sizeof(position) / sizeof(Zobrist::key)
+                              + sizeof(hands   ) / sizeof(Zobrist::key);
+    Zobrist::key            k[n];
+
+    // sort the numbers and compare the neighbors
+    std::copy(&position[0][0],
+              &position[0][0] + sizeof(position) / sizeof(Zobrist::key), k);
+    std::copy(&hands[0][0],
+              &hands[0][0]    + sizeof(hands)    / sizeof(Zobrist::key),
+              k + sizeof(position) / sizeof(Zobrist::key));
+    std::sort(k, k + n);
+
+    for (size_t i = 1; i < n; ++i) {
+        // zeros are the empty squares and the pieces never in the hand
+        if (k[i] != 0 && k[i] == k[i - 1]) {
+            return false;
+        }
+    }
+
+    return true;
 
 }
 
@@ -80,31 +138,24 @@ static Zobrist::key _conv(uint64_t d)
 
 /**
  * Initialize the tables of random numbers
- *
+ * The numbers are taken from a splitmix64 stream started at the fixed
+ * seed, so the keys are the same on any platform and any build. Should
+ * the stream ever give a duplicate, the tables are filled again with the
+ * numbers following in the stream. The tables for the secondary key are
+ * filled with the numbers next to them.
  */
 void Zobrist::initialize (void)
 {
 
-    // initialize random generator
-    utility::initRandom(_seed);
+    uint64_t                state = Seed;
 
-    // initialize random tree
-    utility::initRandomTree();
-
-    //
-    for (auto sq : Square::all) {
-        for (auto p : Piece::all) {
-            position[sq][p] = _conv(utility::uniqueRandom());
-        }
-        position[sq][Piece::EMP] = 0;
-    }
+    do {
+        _fill(state, position, hands);
+    } while (! _unique(position, hands));
 
-    for (auto c : Color::all) {
-        for (auto p : Piece::hand) {
-            hands[c][p]     = _conv(utility::uniqueRandom());
-        }
-        hands[c][Piece::EMP]     = 0;
-    }
+    do {
+        _fill(state, verifyPosition, verifyHands);
+    } while (! _unique(verifyPosition, verifyHands));
 
 }
 
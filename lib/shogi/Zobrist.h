@@ -61,12 +61,21 @@ namespace game { namespace Zobrist {
 /// Type of data being used for hasing key 
 using key = uint64_t;
 
+/// Seed of the random numbers in the tables
+static const uint64_t       Seed = 20160331;
+
 /// Tables for random numbers to hash pieces on the board
 extern key                  position[Square::Squares][Piece::Pieces];
 
 /// Tables for random numbers to hash pieces in the hand
 extern key                  hands[Color::Colors][Piece::Variety];
 
+/// Independent tables for the secondary key (Position::verifier())
+extern key                  verifyPosition[Square::Squares][Piece::Pieces];
+
+/// Independent tables for the secondary key of the hands
+extern key                  verifyHands[Color::Colors][Piece::Variety];
+
 /// Initialize
 void                        initialize (void);
 
@@ -174,6 +174,26 @@ uint64_t uniqueRandom (void)
 
 
 
+/**
+ * Generate a 64 bit random number from splitmix64 stream
+ * The stream depends only on the state given, which is advanced.
+ * @param state state of the stream
+ * @return 64 bit random number
+ */
+uint64_t splitmix (uint64_t &state)
+{
+
+    uint64_t                z = (state += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+    return z ^ (z >> 31);
+
+}
+
+
+
 /**
  * Clean up
  */
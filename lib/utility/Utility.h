@@ -78,6 +78,7 @@ void        initRandom (void);
 uint32_t    random (void);
 uint64_t    Random (void);
 uint64_t    uniqueRandom (void);
+uint64_t    splitmix (uint64_t &);
 void        cleanRandomTree (void);
 
 /* ------------------------------------------------------------------------- */
@@ -0,0 +1,252 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <time.h>
+
+#include <BitOperations.h>
+#include <Shogi.h>
+
+using namespace foundation;
+using namespace game;
+
+/* ------------------------------- parameters ------------------------------ */
+
+// Number of iterations
+static const int            Iterations = 2000000;
+
+// Number of bitboards in a batch (as many as Position::_bbord)
+static const size_t         Batch      = 28;
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* --------------------------- global  variables --------------------------- */
+
+static Bitboard             board[Batch];
+
+static uint32_t             count[Batch];
+
+static uint64_t             reduce[2];
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Elapsed time since the given time
+ * @param start start time
+ * @return nano seconds per iteration
+ */
+static double elapsed (const struct timespec &start)
+{
+
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (static_cast<double>(end.tv_sec  - start.tv_sec ) * 1e9 +
+            static_cast<double>(end.tv_nsec - start.tv_nsec)       ) /
+            Iterations;
+
+}
+
+
+
+/**
+ * Benchmark population count
+ * @param name name of the instruction set
+ * @param f function to be measured
+ * @return sum of the counts to check the result
+ */
+static uint64_t benchPopcnt (const char *name,
+                             void (*f)(const uint64_t *, size_t, uint32_t *))
+{
+
+    const uint64_t *        v   = board[0].p;
+    uint64_t                sum = 0;
+    struct timespec         start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < Iterations; ++i) {
+        f(v, Batch, count);
+        sum += count[i % Batch];
+    }
+    std::cout << "popcnt    " << std::setw(14) << name << " : "
+              << std::setw(8)  << elapsed(start) << " nsec" << std::endl;
+
+    sum = 0;
+    for (size_t i = 0; i < Batch; ++i) {
+        sum = sum * 131 + count[i];
+    }
+
+    return sum;
+
+}
+
+
+
+/**
+ * Benchmark LSB
+ * @param name name of the instruction set
+ * @param f function to be measured
+ * @return sum of the squares to check the result
+ */
+static uint64_t benchLsb (const char *name,
+                          void (*f)(const uint64_t *, size_t, uint32_t *,
+                                    uint32_t))
+{
+
+    const uint64_t *        v   = board[0].p;
+    uint64_t                sum = 0;
+    struct timespec         start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < Iterations; ++i) {
+        f(v, Batch, count, 63);
+        sum += count[i % Batch];
+    }
+    std::cout << "lsb       " << std::setw(14) << name << " : "
+              << std::setw(8)  << elapsed(start) << " nsec" << std::endl;
+
+    sum = 0;
+    for (size_t i = 0; i < Batch; ++i) {
+        sum = sum * 131 + count[i];
+    }
+
+    return sum;
+
+}
+
+
+
+/**
+ * Benchmark AND/OR reduction
+ * @param name name of the instruction set
+ * @param f function to be measured
+ * @return result to check
+ */
+static uint64_t benchReduce (const char *name,
+                             void (*f)(const uint64_t *, size_t, uint64_t *))
+{
+
+    const uint64_t *        v   = board[0].p;
+    uint64_t                sum = 0;
+    struct timespec         start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < Iterations; ++i) {
+        f(v, Batch, reduce);
+        sum += reduce[i & 1];
+    }
+    std::cout << "reduce    " << std::setw(14) << name << " : "
+              << std::setw(8)  << elapsed(start) << " nsec" << std::endl;
+
+    return reduce[0] ^ (reduce[1] * 131);
+
+}
+
+
+
+/**
+ * Main function
+ * @param argc number of command option when invoked.
+ * @param argv strings of comannd options in array.
+ * @return status code reflecting normal end or error end.
+ */
+int main (int, char *[])
+{
+
+    using namespace Bitope;
+
+    // random bitboards, some of them sparse in the upper word only and
+    // one of them empty
+    srand(20160331);
+    for (size_t n = 0; n < Batch - 1; ++n) {
+        bool                upper = n % 4 == 0;
+        for (int i = upper ? 63 : 0; i < 81; ++i) {
+            if (upper ? rand() % 8 == 0 : rand() % 4 != 0) {
+                board[n] |= Bitboard::Square[i];
+            }
+        }
+    }
+
+    std::cout << "SIMD level : " << simd() << std::endl;
+
+    // population count
+    auto pc = benchPopcnt("scalar", popcntsScalar);
+    if (simd() >= AVX2) {
+        if (benchPopcnt("AVX2", popcntsAVX2) != pc) {
+            std::cout << "AVX2 popcnt Error." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (simd() >= AVX512) {
+        if (benchPopcnt("AVX-512", popcntsAVX512) != pc) {
+            std::cout << "AVX-512 popcnt Error." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (simd() >= AVX512POPCNT) {
+        if (benchPopcnt("AVX-512 VPOPCNT", popcntsAVX512POPCNT) != pc) {
+            std::cout << "VPOPCNTQ popcnt Error." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // LSB
+    auto ls = benchLsb("scalar", lsbsScalar);
+    if (simd() >= AVX512 && benchLsb("AVX-512 CD", lsbsAVX512) != ls) {
+        std::cout << "AVX-512 lsb Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // AND reduction
+    auto ar = benchReduce("AND scalar", reduceScalar<true>);
+    if (simd() >= AVX2 && benchReduce("AND AVX2", reduceAVX2<true>) != ar) {
+        std::cout << "AVX2 AND Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (simd() >= AVX512 && benchReduce("AND AVX-512", reduceAVX512<true>) != ar) {
+        std::cout << "AVX-512 AND Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // OR reduction
+    auto or_ = benchReduce("OR scalar", reduceScalar<false>);
+    if (simd() >= AVX2 && benchReduce("OR AVX2", reduceAVX2<false>) != or_) {
+        std::cout << "AVX2 OR Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (simd() >= AVX512 && benchReduce("OR AVX-512", reduceAVX512<false>) != or_) {
+        std::cout << "AVX-512 OR Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Bitboard interface against the scalar loop
+    Bitboard all(Bitboard::Fill), any(Bitboard::Zero);
+    for (auto &b : board) {
+        all = all & b;
+        any = any | b;
+    }
+    Bitboard::popcnt(board, Batch, count);
+    for (size_t i = 0; i < Batch; ++i) {
+        if (count[i] != board[i].popcnt()) {
+            std::cout << "Bitboard::popcnt Error." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    Bitboard::lsb(board, Batch, count);
+    for (size_t i = 0; i < Batch; ++i) {
+        if (count[i] != (board[i] ? static_cast<uint32_t>(board[i].lsb())
+                                  : Bitope::NoBit)) {
+            std::cout << "Bitboard::lsb Error." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    if ((Bitboard::intersect(board, Batch) ^ all) ||
+        (Bitboard::merge    (board, Batch) ^ any)   ) {
+        std::cout << "Bitboard reduction Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    exit(EXIT_SUCCESS);
+
+}
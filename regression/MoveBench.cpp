@@ -2,6 +2,7 @@
 #include <fstream>
 #include <string>
 #include <iomanip>
+#include <time.h>
 
 #include <Array.h>
 #include <Shogi.h>
@@ -12,6 +13,9 @@ using namespace game;
 
 /* ------------------------------- parameters ------------------------------ */
 
+// Number of iterations
+static const int            Iterations = 5000000;
+
 /* ------------------------------------------------------------------------- */
 
 
@@ -64,12 +68,39 @@ int main (int argc, char *argv[])
     Position p(f.summary());
     p.show();
 
-    for (int i = 0; i < 5000000; ++i) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int i = 0; i < Iterations; ++i) {
         move.setsz(0);
         p.genMove(move);
     }
 
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = static_cast<double>(end.tv_sec  - start.tv_sec ) +
+                     static_cast<double>(end.tv_nsec - start.tv_nsec) * 1e-9;
+
     std::cout << "Number of moves :" << move.vsize() << std::endl;
+    std::cout << "Elapsed time    :" << elapsed << " sec ("
+              << elapsed * 1e9 / Iterations << " nsec/genMove)" << std::endl;
+
+    // make and undo every move, which includes updating the hash keys
+    const int   rounds = Iterations / 100;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int i = 0; i < rounds; ++i) {
+        for (auto m : move) {
+            p.undo(p.move(m));
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    elapsed = static_cast<double>(end.tv_sec  - start.tv_sec ) +
+              static_cast<double>(end.tv_nsec - start.tv_nsec) * 1e-9;
+
+    std::cout << "Elapsed time    :" << elapsed << " sec ("
+              << elapsed * 1e9 / rounds / static_cast<double>(move.vsize())
+              << " nsec/move+undo)" << std::endl;
     printMove(p);
 
     exit(EXIT_SUCCESS);
@@ -114,9 +114,31 @@ bool MyPosition::chkHash (void)
     Zobrist::key key   = _key;
     Zobrist::key board = _keyBoard;
     Zobrist::key hands = _keyHands;
+#ifdef USE_WIDEHASHKEY
+    Zobrist::key vboard = _vkeyBoard;
+    Zobrist::key vhands = _vkeyHands;
+#endif
+#ifdef USE_SUBHASHKEY
+    Zobrist::key pawn   = _keyPawn;
+    Zobrist::key kingB  = _keyKing[Color::Black];
+    Zobrist::key kingW  = _keyKing[Color::White];
+#endif
 
     _hashFull();
 
+#ifdef USE_WIDEHASHKEY
+    if (vboard != _vkeyBoard || vhands != _vkeyHands) {
+        return false;
+    }
+#endif
+
+#ifdef USE_SUBHASHKEY
+    if (pawn  != _keyPawn ||
+        kingB != _keyKing[Color::Black] || kingW != _keyKing[Color::White]) {
+        return false;
+    }
+#endif
+
     if (key   != _key)      {
         return false;
     }
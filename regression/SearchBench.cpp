@@ -0,0 +1,124 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <time.h>
+
+#include <Shogi.h>
+#include <CSAFile.h>
+
+using namespace game;
+
+/* ------------------------------- parameters ------------------------------ */
+
+// Depth searched
+static const int            Depth      = 4;
+
+// Interval of the positions searched in the kifu
+static const int            Interval   = 30;
+
+// Size of the transposition table in MiB
+static const size_t         TableSize  = 64;
+
+// Numbers of threads measured
+static const int            Threads[]  = { 1, 2, 4, 8, 16 };
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/**
+ * Search the positions and measure the time
+ * The table is cleared first, so every run starts from the same state.
+ * @param ps positions
+ * @param n number of threads
+ * @param s scheduler
+ * @param nodes number of nodes searched
+ * @return elapsed time in seconds
+ */
+static double measure (std::vector<Position> &ps, int n,
+                       Search::Scheduler s, uint64_t &nodes)
+{
+
+    TranspositionTable      t(TableSize);
+    Search                  search(t, n, s);
+    struct timespec         start, end;
+
+    nodes = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (auto &p : ps) {
+        search.go(p, Depth);
+        nodes += search.nodes();
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return static_cast<double>(end.tv_sec  - start.tv_sec ) +
+           static_cast<double>(end.tv_nsec - start.tv_nsec) * 1e-9;
+
+}
+
+
+
+/**
+ * Main function
+ * @param argc number of command option when invoked.
+ * @param argv strings of comannd options in array.
+ * @return status code reflecting normal end or error end.
+ */
+int main (int argc, char *argv[])
+{
+
+    // check argument
+    if (argc != 2) {
+        std::cerr << "Command Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // initialization
+    Shogi::initialize();
+
+    // set piece values
+    Position::setValue  (Evaluation::Value);
+    Position::handsValue(Evaluation::Hands);
+
+    // read kifu file
+    CSAFile f(argv[1]);
+    Position p(f.summary());
+    std::vector<Position>   ps;
+    int                     n = 0;
+    for (auto m : f) {
+        if (n++ % Interval == 0) {
+            ps.push_back(p);
+        }
+        p.move(m);
+    }
+
+    std::cout << ps.size() << " positions, depth " << Depth << std::endl;
+
+    // time to depth against one thread
+    for (auto s : { Search::LazySMP, Search::YBWC }) {
+        std::cout << (s == Search::LazySMP ? "Lazy SMP" : "YBWC")
+                  << std::endl;
+        double              base = 0.0;
+        for (auto t : Threads) {
+            uint64_t        nodes;
+            double          elapsed = measure(ps, t, s, nodes);
+            if (t == 1) {
+                base = elapsed;
+            }
+            std::cout << std::setw(4)  << t << " threads :"
+                      << std::setw(10) << std::fixed << std::setprecision(3)
+                      << elapsed << " sec"
+                      << std::setw(12) << nodes << " nodes"
+                      << std::setw(12) << static_cast<uint64_t>(
+                                            static_cast<double>(nodes) /
+                                            elapsed) << " nps"
+                      << "  speedup " << std::setprecision(2)
+                      << base / elapsed << std::endl;
+        }
+    }
+
+    exit(EXIT_SUCCESS);
+
+}
@@ -0,0 +1,349 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include <time.h>
+
+#include <Shogi.h>
+#include <CSAFile.h>
+
+using namespace game;
+
+/* ------------------------------- parameters ------------------------------ */
+
+// Number of moves sorted in a benchmark
+static const size_t         Total      = 4000000;
+
+// Numbers of the moves in the random positions (593 is the most known)
+static const size_t         Lengths[]  = { 8, 16, 32, 48, 80, 128, 256, 593 };
+
+// Number of the moves picked before sorting the rest
+static const size_t         Picks      = 3;
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* -------------------------------- types ---------------------------------- */
+
+// Moves in a position
+using Moves                 = History::Moves;
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/**
+ * Elapsed time since the given time
+ * @param start start time
+ * @param n number of the moves sorted
+ * @return nano seconds per move
+ */
+static double elapsed (const struct timespec &start, size_t n)
+{
+
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (static_cast<double>(end.tv_sec  - start.tv_sec ) * 1e9 +
+            static_cast<double>(end.tv_nsec - start.tv_nsec)       ) /
+            static_cast<double>(n);
+
+}
+
+
+
+/**
+ * Bubble sort in decending order (the former Array::dcsort)
+ * @param m moves
+ */
+static void bubble (Moves &m)
+{
+
+    for (int i = 0; i < static_cast<int>(m.vsize() - 1); ++i) {
+        for (int j = static_cast<int>(m.vsize() - 1); j > i; --j) {
+            if (m[j] > m[j - 1]) {
+                Move::Move  t = m[  j  ];
+                m[  j  ] = m[j - 1];
+                m[j - 1] = t;
+            }
+        }
+    }
+
+}
+
+
+
+/**
+ * Insertion sort (or std::sort) in decending order
+ * @param m moves
+ */
+static void dcsort (Moves &m)
+{
+
+    m.dcsort();
+
+}
+
+
+
+/**
+ * Radix sort in decending order of the values
+ * @param m moves
+ */
+static void rdsort (Moves &m)
+{
+
+    m.rdsort();
+
+}
+
+
+
+/**
+ * Pick the first moves and sort the rest as the search does
+ * @param m moves
+ */
+static void staged (Moves &m)
+{
+
+    for (size_t i = 0; i < Picks && i < m.vsize(); ++i) {
+        m.dcpick(i);
+    }
+    if (m.vsize() > Picks) {
+        m.rdsort(Picks);
+    }
+
+}
+
+
+
+/**
+ * Check if the moves are in decending order of the values
+ * @param m moves sorted
+ * @return true if sorted
+ */
+static bool sorted (Moves &m)
+{
+
+    for (size_t i = 1; i < m.vsize(); ++i) {
+        if ((m[i - 1] >> 16) < (m[i] >> 16)) {
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+
+
+/**
+ * Check if the moves from the index are in ascending order of the values
+ * and the moves before the index are left as they were
+ * @param m moves sorted
+ * @param s moves before sorting
+ * @param from index of the first move sorted
+ * @return true if sorted
+ */
+static bool ascending (Moves &m, Moves &s, size_t from)
+{
+
+    for (size_t i = 0; i < from && i < m.vsize(); ++i) {
+        if (m[i] != s[i]) {
+            return false;
+        }
+    }
+    for (size_t i = from + 1; i < m.vsize(); ++i) {
+        if ((m[i - 1] >> 16) > (m[i] >> 16)) {
+            return false;
+        }
+    }
+
+    return m.vsize() == s.vsize();
+
+}
+
+
+
+/**
+ * Check the sorts in ascending order, which the search does not use
+ * @param sets sets of the moves
+ * @return true if all the sets are sorted
+ */
+static bool checkAscending (std::vector<Moves> &sets)
+{
+
+    Moves                   m;
+
+    for (auto &s : sets) {
+        // the insertion sort (or std::sort) and the radix sort from the
+        // index
+        for (size_t from : { static_cast<size_t>(0), Picks }) {
+            m = s;
+            m.acsort(from);
+            if (! ascending(m, s, from)) {
+                return false;
+            }
+            m = s;
+            m.rasort(from);
+            if (! ascending(m, s, from)) {
+                return false;
+            }
+        }
+        // the smallest moves picked come first in order, and none of the
+        // rest is smaller
+        m = s;
+        for (size_t i = 0; i < Picks && i < m.vsize(); ++i) {
+            m.acpick(i);
+        }
+        for (size_t i = 1; i < m.vsize(); ++i) {
+            size_t          j = std::min(i, Picks);
+            if (j > 0 && (m[j - 1] >> 16) > (m[i] >> 16)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+
+}
+
+
+
+/**
+ * Benchmark a sort over the sets of the moves
+ * @param name name of the sort
+ * @param f sort to be measured
+ * @param sets sets of the moves
+ * @return true if all the sets are sorted
+ */
+static bool bench (const char *name, void (*f)(Moves &),
+                   std::vector<Moves> &sets)
+{
+
+    size_t                  moves = 0;
+    for (auto &s : sets) {
+        moves += s.vsize();
+    }
+    size_t                  rounds = Total / moves + 1;
+
+    Moves                   m;
+    struct timespec         start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t r = 0; r < rounds; ++r) {
+        for (auto &s : sets) {
+            m = s;
+            f(m);
+        }
+    }
+    std::cout << std::setw(8) << name << " : " << std::setw(8)
+              << elapsed(start, rounds * moves) << " nsec/move" << std::endl;
+
+    for (auto &s : sets) {
+        m = s;
+        f(m);
+        if (! sorted(m)) {
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+
+
+/**
+ * Benchmark all the sorts
+ * @param title title of the sets
+ * @param sets sets of the moves
+ */
+static void benchAll (const std::string &title, std::vector<Moves> &sets)
+{
+
+    std::cout << title << std::endl;
+    if (! bench("bubble", bubble, sets) ||
+        ! bench("dcsort", dcsort, sets) ||
+        ! bench("rdsort", rdsort, sets) ||
+        ! bench("staged", staged, sets)) {
+        std::cout << "Sort Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+}
+
+
+
+/**
+ * Main function
+ * @param argc number of command option when invoked.
+ * @param argv strings of comannd options in array.
+ * @return status code reflecting normal end or error end.
+ */
+int main (int argc, char *argv[])
+{
+
+    // check argument
+    if (argc != 2) {
+        std::cerr << "Command Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // initialization
+    Shogi::initialize();
+
+    // set piece values
+    Position::setValue  (Evaluation::Value);
+    Position::handsValue(Evaluation::Hands);
+
+    // read kifu files
+    std::vector<std::string> kifu;
+    std::ifstream ifs(argv[1]);
+    std::string   l;
+    while (! (std::getline(ifs, l)).eof()) {
+        kifu.push_back(l);
+    }
+
+    // the moves in the games scored as the search does, which have few
+    // distinct values but the captures
+    std::vector<Moves>      games;
+    History *               h = new History();
+    for (auto &k : kifu) {
+        CSAFile f(k);
+        Position p(f.summary());
+        for (auto m : f) {
+            Moves           g;
+            p.genMove(g);
+            h->score(p, g, 0, p.lastMove());
+            games.push_back(g);
+            p.move(m);
+        }
+    }
+    delete h;
+    benchAll("positions in the games (" + std::to_string(games.size())
+             + " sets)", games);
+
+    // random values from the typical number of the moves to the worst
+    srand(20261018);
+    for (auto n : Lengths) {
+        std::vector<Moves>  sets(64);
+        for (auto &s : sets) {
+            for (size_t i = 0; i < n; ++i) {
+                s.add(Move::setValue(rand() % 32768 - 16384,
+                                     static_cast<Move::Move>(i)));
+            }
+        }
+        benchAll(std::to_string(n) + " moves of random values", sets);
+        if (! checkAscending(sets)) {
+            std::cout << "Ascending Sort Error." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    exit(EXIT_SUCCESS);
+
+}
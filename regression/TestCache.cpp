@@ -0,0 +1,194 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+#include <Shogi.h>
+#include <CSAFile.h>
+
+using namespace game;
+
+/* ------------------------------- parameters ------------------------------ */
+
+// Number of threads racing on the cache
+static const int            Threads    = 4;
+
+// Number of operations per thread
+static const int            Operations = 2000000;
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* --------------------------- global  variables --------------------------- */
+
+// Cache shared by the positions (and the threads)
+static EvalCache<> *        _cache     = nullptr;
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Position evaluated through the cache
+ */
+class CachedPosition : public Position
+{
+
+public:
+
+    /// Constructor takes CSA game summary
+    CachedPosition (const CSASummary &g) : Position(g) {}
+
+    /// Evaluate the position looking up the cache first
+    Evaluation::Eval eval (void) override
+    {
+        Evaluation::Eval    v;
+        if (_cache->probe(hash(), v)) {
+            return v;
+        }
+        v = Position::eval();
+        _cache->store(hash(), v);
+        return v;
+    }
+
+};
+
+
+
+/**
+ * Value derived from the key
+ * Every hit must carry exactly this value, whoever stored the entry.
+ */
+static Evaluation::Eval valueOf (Zobrist::key k) {
+                            return static_cast<int>((k >> 40) % 60000) - 30000;
+                        }
+
+
+
+/**
+ * Thread storing and probing random keys on the shared cache
+ * @param arg seed of the keys
+ * @return number of inconsistent hits
+ */
+static void * race (void *arg)
+{
+
+    uint64_t                x    = reinterpret_cast<uintptr_t>(arg);
+    uintptr_t               bad  = 0;
+    Evaluation::Eval        v;
+
+    for (int i = 0; i < Operations; ++i) {
+        // xorshift
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        // a small key space makes the threads hit each others entries
+        Zobrist::key k = (x & 0xfff) * 0x9e3779b97f4a7c15ULL;
+        if (i & 1) {
+            _cache->store(k, valueOf(k));
+        } else
+        if (_cache->probe(k, v) && v != valueOf(k)) {
+            ++bad;
+        }
+    }
+
+    return reinterpret_cast<void *>(bad);
+
+}
+
+
+
+/**
+ * Main function
+ * @param argc number of command option when invoked.
+ * @param argv strings of comannd options in array.
+ * @return status code reflecting normal end or error end.
+ */
+int main (int argc, char *argv[])
+{
+
+    // check argument
+    if (argc != 2) {
+        std::cerr << "Command Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // initialization
+    Shogi::initialize();
+
+    // set piece values
+    Position::setValue  (Evaluation::Value);
+    Position::handsValue(Evaluation::Hands);
+
+    // read kifu files
+    std::vector<std::string> kifu;
+    std::ifstream ifs(argv[1]);
+    std::string   l;
+    while (! (std::getline(ifs, l)).eof()) {
+        kifu.push_back(l);
+    }
+
+    // the cached evaluations are the same as the evaluations, and the
+    // second pass over the same positions hits the cache
+    EvalCache<>             c(16384);
+    uint64_t                probes = 0;
+    uint64_t                hits   = 0;
+    _cache = &c;
+    for (int pass = 0; pass < 2; ++pass) {
+        probes = c.probes();
+        hits   = c.hits();
+        for (auto &k : kifu) {
+            CSAFile f(k);
+            CachedPosition p(f.summary());
+            for (auto m : f) {
+                if (p.eval() != p.Position::eval()) {
+                    std::cout << "Eval error : " << std::endl
+                              << p << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+                p.move(m);
+            }
+        }
+        probes = c.probes() - probes;
+        hits   = c.hits()   - hits;
+        std::cout << "Pass " << pass << " : " << hits << "/"
+                  << probes << " hits" << std::endl;
+    }
+    if (probes == 0 || hits * 10 < probes * 9) {
+        std::cout << "Hit rate error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // the key 0 (no FU on board) is not taken for an empty entry
+    EvalCache<int16_t>      u(1);
+    int16_t                 s;
+    if (u.probe(0, s)) {
+        std::cout << "Empty entry error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    u.store(0, -1);
+    if (! u.probe(0, s) || s != -1 || u.hitrate() != 500) {
+        std::cout << "Store error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // racing threads never see torn entries
+    EvalCache<>             r(16);
+    pthread_t               th[Threads];
+    uintptr_t               bad = 0;
+    _cache = &r;
+    for (int i = 0; i < Threads; ++i) {
+        pthread_create(&th[i], nullptr, race,
+                       reinterpret_cast<void *>(0x1234567ULL * (i + 1)));
+    }
+    for (int i = 0; i < Threads; ++i) {
+        void *              p;
+        pthread_join(th[i], &p);
+        bad += reinterpret_cast<uintptr_t>(p);
+    }
+    if (bad != 0) {
+        std::cout << "Inconsistent entries : " << bad << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    exit(EXIT_SUCCESS);
+
+}
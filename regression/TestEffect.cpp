@@ -524,6 +524,88 @@ static bool checkEffect  (const Position &p)
 
 
 
+static bool checkBulk (const Position &p)
+{
+
+    for (auto pc : Piece::all) {
+
+        if (pc == EMP) {
+            continue;
+        }
+
+        // union of the effects of each piece
+        Bitboard bbd(p.bitboard(pc));
+        Bitboard ocp(p.occupied());
+        Bitboard e;
+        for (auto sq : bbd) {
+            switch (pc) {
+            case BKY:
+            case WKY:
+                e |= Effect::KY(color(pc), sq, ocp);
+                break;
+            case BKA:
+            case WKA:
+            case BUM:
+            case WUM:
+                e |= Effect::KA(sq, ocp) | Effect::AD(sq, pc);
+                break;
+            case BHI:
+            case WHI:
+            case BRY:
+            case WRY:
+                e |= Effect::HI(sq, ocp) | Effect::AD(sq, pc);
+                break;
+            default:
+                e |= Effect::AD(sq, pc);
+                break;
+            }
+        }
+
+        Bitboard b(Effect::bulk(pc, bbd, ocp));
+        if ((b ^ e)) {
+            return exitInError(p, "Bulk Error");
+        }
+
+    }
+
+    return true;
+
+}
+
+
+
+#ifdef USE_ATTACKCOUNTMAP
+static bool checkCount (const Position &p)
+{
+
+    int count[Color::Colors][SQVD] = {};
+
+    for (auto pc : Piece::all) {
+        if (pc == EMP) {
+            continue;
+        }
+        for (auto sq : p.bitboard(pc)) {
+            for (auto e : Effect::bulk(pc, Bitboard::Square[sq], p.occupied())) {
+                ++count[color(pc)][e];
+            }
+        }
+    }
+
+    for (auto c : Color::all) {
+        for (auto sq : Square::all) {
+            if (p.attackers(c, sq) != count[c][sq]) {
+                return exitInError(p, "Count Error");
+            }
+        }
+    }
+
+    return true;
+
+}
+#endif
+
+
+
 int main (int argc, char *argv[])
 {
 
@@ -551,6 +633,16 @@ int main (int argc, char *argv[])
                 std::cout << l << " ";
                 exit(EXIT_FAILURE);
             }
+            if (! checkBulk(p)) {
+                std::cout << l << " ";
+                exit(EXIT_FAILURE);
+            }
+#ifdef USE_ATTACKCOUNTMAP
+            if (! checkCount(p)) {
+                std::cout << l << " ";
+                exit(EXIT_FAILURE);
+            }
+#endif
             if (m.move[0] == '%') {
                 break;
             }
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+
+#include <Shogi.h>
+#include <CSAFile.h>
+
+using namespace game;
+
+/* ------------------------------- parameters ------------------------------ */
+
+// Number of random hands compared
+static const int            Trials = 1000000;
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Main function
+ * @param argc number of command option when invoked.
+ * @param argv strings of comannd options in array.
+ * @return status code reflecting normal end or error end.
+ */
+int main (int argc, char *argv[])
+{
+
+    // check argument
+    if (argc != 2) {
+        std::cerr << "Command Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // initialization
+    Shogi::initialize();
+
+    // set piece values
+    Position::setValue  (Evaluation::Value);
+    Position::handsValue(Evaluation::Hands);
+
+    // packed hands of the positions in the kifu files
+    HandTable<int>          t(4);
+    std::ifstream ifs(argv[1]);
+    std::string   l;
+    while (! (std::getline(ifs, l)).eof()) {
+        CSAFile f(l);
+        Position p(f.summary());
+        int      ply = 0;
+        for (auto m : f) {
+            for (auto c : Color::all) {
+                auto h = p.hand(c);
+                for (auto pc : Piece::hand) {
+                    if (Hand::count(h, pc) != p.hand(c, pc)) {
+                        std::cout << "Pack error : " << std::endl
+                                  << p << std::endl;
+                        exit(EXIT_FAILURE);
+                    }
+                }
+            }
+            // the hash key is made of the board and the hands
+            t.store(p.hashBoard(), p.hand(Color::Black), ply);
+            int n;
+            if (! t.probe(p.hashBoard(), p.hand(Color::Black), n) ||
+                n != ply) {
+                std::cout << "Probe error : " << std::endl
+                          << p << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            p.move(m);
+            ++ply;
+        }
+    }
+
+    // superiority against counting the pieces one by one
+    srand(20160331);
+    for (int i = 0; i < Trials; ++i) {
+        int                 a[Piece::Kind] = {0};
+        int                 b[Piece::Kind] = {0};
+        bool                sup = true;
+        for (auto pc : Piece::hand) {
+            int max = (pc == Piece::FU ? 18 :
+                       pc == Piece::KA || pc == Piece::HI ? 2 : 4);
+            a[pc]   = rand() % (max + 1);
+            b[pc]   = rand() % 4 == 0 ? a[pc] : rand() % (max + 1);
+            sup     = sup && a[pc] >= b[pc];
+        }
+        auto ha = Hand::pack(a);
+        auto hb = Hand::pack(b);
+        if (Hand::superior(ha, hb) != sup || Hand::inferior(hb, ha) != sup) {
+            std::cout << "Superiority error." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // the board proven with an inferior hand
+    int                     inf[Piece::Kind] = {0, 1, 0, 0, 1, 0, 0, 0};
+    int                     sup[Piece::Kind] = {0, 2, 0, 0, 1, 0, 0, 1};
+    int                     oth[Piece::Kind] = {0, 0, 1, 0, 1, 0, 0, 1};
+    Zobrist::key            board = 0x0123456789abcdefULL;
+    int                     v;
+    auto                    proven = [] (int x) { return x == 0; };
+    t.store(board, Hand::pack(inf), 0);
+    if (! t.inferior(board, Hand::pack(sup), proven, v) ||
+          t.inferior(board, Hand::pack(oth), proven, v) ||
+          t.superior(board, Hand::pack(sup), proven, v) ||
+        ! t.superior(board, Hand::pack(inf), proven, v)   ) {
+        std::cout << "Dominance error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    exit(EXIT_SUCCESS);
+
+}
@@ -0,0 +1,172 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <Shogi.h>
+#include <CSAFile.h>
+
+using namespace game;
+
+/* ------------------------------- parameters ------------------------------ */
+
+// Number of cutoffs learned to saturate the history
+static const int            Saturate   = 10000;
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/**
+ * Check the order of the scored moves
+ * The capturing moves come first, then the killer moves, the countermove
+ * and the other quiet moves.
+ * @param p position
+ * @param m moves sorted by the scores
+ * @param k killer move expected first among the quiet moves
+ * @return true if ordered
+ */
+static bool ordered (const Position &p, History::Moves &m,
+                     Move::Move k)
+{
+
+    bool                    quiet = false;
+
+    for (auto move : m) {
+        bool                q = History::quiet(p, move);
+        if (quiet && ! q) {
+            return false;
+        }
+        if (q && ! quiet && k != Move::None &&
+            (move & Move::MoveMask) != k) {
+            return false;
+        }
+        quiet = quiet || q;
+    }
+
+    return true;
+
+}
+
+
+
+/**
+ * Main function
+ * @param argc number of command option when invoked.
+ * @param argv strings of comannd options in array.
+ * @return status code reflecting normal end or error end.
+ */
+int main (int argc, char *argv[])
+{
+
+    // check argument
+    if (argc != 2) {
+        std::cerr << "Command Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // initialization
+    Shogi::initialize();
+
+    // set piece values
+    Position::setValue  (Evaluation::Value);
+    Position::handsValue(Evaluation::Hands);
+
+    // read kifu files
+    std::vector<std::string> kifu;
+    std::ifstream ifs(argv[1]);
+    std::string   l;
+    while (! (std::getline(ifs, l)).eof()) {
+        kifu.push_back(l);
+    }
+
+    // the scores keep the moves, and the capturing moves come first; a
+    // quiet move learned as the killer comes first among the quiet moves
+    // and is taken as the countermove of the previous move at another ply
+    History *               h = new History();
+    for (auto &k : kifu) {
+        CSAFile f(k);
+        Position p(f.summary());
+        for (auto m : f) {
+            History::Moves  g;
+            History::Moves  s;
+            p.genMove(g);
+            s = g;
+            h->score(p, s, 0, p.lastMove());
+            s.dcsort();
+            if (s.vsize() != g.vsize() || ! ordered(p, s, Move::None)) {
+                std::cout << "Order error : " << std::endl << p << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            for (size_t i = 0; i < s.vsize(); ++i) {
+                size_t      j = 0;
+                while (j < g.vsize() && g[j] != (s[i] & Move::MoveMask)) {
+                    ++j;
+                }
+                if (j == g.vsize()) {
+                    std::cout << "Move error : " << std::endl
+                              << p << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            Move::Move      q = Move::None;
+            for (auto move : g) {
+                if (History::quiet(p, move)) {
+                    q = move;
+                }
+            }
+            if (q != Move::None) {
+                h->good(p.turn(), q, nullptr, 0, 1, 4, p.lastMove());
+                h->score(p, s, 1, Move::None);
+                s.dcsort();
+                if (! ordered(p, s, q) || h->killer(1, 0) != q) {
+                    std::cout << "Killer error : " << std::endl
+                              << p << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+                if (! Move::isNull(p.lastMove()) &&
+                    h->counter(p.lastMove()) != q) {
+                    std::cout << "Countermove error : " << std::endl
+                              << p << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            p.move(m);
+        }
+    }
+
+    // the gravity keeps the history within the limit
+    h->clear();
+    Move::Move              a = static_cast<Move::Move>(
+                                    (Square::SQ55 << 7) | Square::SQ54);
+    Move::Move              b = static_cast<Move::Move>(
+                                    (Square::SQ56 << 7) | Square::SQ55);
+    for (int i = 0; i < Saturate; ++i) {
+        h->good(Color::Black, a, &b, 1, 0, 30, Move::None);
+    }
+    if (h->history(Color::Black, a) >  History::Limit ||
+        h->history(Color::Black, a) <= 0              ||
+        h->history(Color::Black, b) < -History::Limit ||
+        h->history(Color::Black, b) >= 0              ||
+        h->history(Color::White, a) != 0) {
+        std::cout << "Gravity error : " << h->history(Color::Black, a)
+                  << " " << h->history(Color::Black, b) << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // a dropping move has its own row apart from the squares
+    Move::Move              d = static_cast<Move::Move>(Move::Drop |
+                                    (Piece::FU << 7) | Square::SQ54);
+    Move::Move              e = static_cast<Move::Move>(
+                                    (Piece::FU << 7) | Square::SQ54);
+    h->clear();
+    h->good(Color::Black, d, nullptr, 0, 0, 8, Move::None);
+    if (h->history(Color::Black, d) <= 0 || h->history(Color::Black, e) != 0) {
+        std::cout << "Drop error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    delete h;
+
+    exit(EXIT_SUCCESS);
+
+}
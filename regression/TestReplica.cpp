@@ -0,0 +1,182 @@
+#include <iostream>
+#include <cstdlib>
+#include <pthread.h>
+
+#include <Shogi.h>
+
+using namespace game;
+
+/* ------------------------------- parameters ------------------------------ */
+
+// Number of threads replicating the tables at once
+static const int            Threads    = 8;
+
+// Number of the NUMA nodes the threads are spread over
+static const int            Replicas   = 2;
+
+// Number of random occupancies checked
+static const int            Samples    = 64;
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* --------------------------- global  variables --------------------------- */
+
+// Occupancies checked
+static Bitboard             _occupied[Samples];
+
+// Effects read from the master tables
+static Bitboard             _expected[Samples][Square::Squares][5];
+
+#ifdef USE_HUGEPAGEEFFECTTABLE
+// Threads waiting to replicate at once
+static pthread_barrier_t    _start;
+#endif
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* -------------------------------- types ---------------------------------- */
+
+// Result of a thread
+struct Result {
+    int                     node;
+    bool                    attached;
+    bool                    matched;
+    const Bitboard *        table;
+};
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/**
+ * Effects of the square on the occupancy
+ * @param sq square
+ * @param m occupancy
+ * @param e array of 5 effects
+ */
+static void effects (Square::Square sq, const Bitboard &m, Bitboard *e)
+{
+
+    e[0] = Effect::KA(sq, m);
+    e[1] = Effect::HI(sq, m);
+    e[2] = Effect::KY(Color::Black, sq, m);
+    e[3] = Effect::KY(Color::White, sq, m);
+    e[4] = Effect::AD(sq, Piece::BKI);
+
+}
+
+
+
+#ifdef USE_HUGEPAGEEFFECTTABLE
+/**
+ * Thread replicating the tables on its node and reading them
+ * @param arg result
+ * @return nullptr
+ */
+static void * reader (void *arg)
+{
+
+    Result &                r = *static_cast<Result *>(arg);
+
+    pthread_barrier_wait(&_start);
+    r.attached = Effect::replicate(r.node) && Effect::attach(r.node);
+    r.table    = &Effect::HI(Square::SQ55, Bitboard::Zero);
+    r.matched  = true;
+    for (int i = 0; i < Samples; ++i) {
+        for (int sq = 0; sq < Square::Squares; ++sq) {
+            Bitboard        e[5];
+            effects(static_cast<Square::Square>(sq), _occupied[i], e);
+            for (int k = 0; k < 5; ++k) {
+                if (e[k] ^ _expected[i][sq][k]) {
+                    r.matched = false;
+                }
+            }
+        }
+    }
+    Effect::attach(-1);
+
+    return nullptr;
+
+}
+#endif
+
+
+
+/**
+ * Main function
+ * @param argc number of command option when invoked.
+ * @param argv strings of comannd options in array.
+ * @return status code reflecting normal end or error end.
+ */
+int main (int, char *[])
+{
+
+    // initialization
+    Shogi::initialize();
+
+    // effects on the master tables
+    srand(20261018);
+    for (int i = 0; i < Samples; ++i) {
+        for (int sq = 0; sq < Square::Squares; ++sq) {
+            if (rand() % 3 == 0) {
+                _occupied[i] |= Bitboard::Square[sq];
+            }
+        }
+        for (int sq = 0; sq < Square::Squares; ++sq) {
+            effects(static_cast<Square::Square>(sq), _occupied[i],
+                    _expected[i][sq]);
+        }
+    }
+    const Bitboard *        master = &Effect::HI(Square::SQ55, Bitboard::Zero);
+
+#ifdef USE_HUGEPAGEEFFECTTABLE
+    // the threads replicating the same node at once share one replica, and
+    // read the same effects as the master through it
+    pthread_t               th[Threads];
+    Result                  r [Threads];
+    pthread_barrier_init(&_start, nullptr, Threads);
+    for (int i = 0; i < Threads; ++i) {
+        r[i].node = i % Replicas;
+        pthread_create(&th[i], nullptr, reader, &r[i]);
+    }
+    for (int i = 0; i < Threads; ++i) {
+        pthread_join(th[i], nullptr);
+    }
+    pthread_barrier_destroy(&_start);
+    for (int i = 0; i < Threads; ++i) {
+        if (! r[i].attached || ! r[i].matched) {
+            std::cout << "Replica error : node " << r[i].node << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        if (r[i].table == master ||
+            r[i].table != r[r[i].node].table) {
+            std::cout << "Replica table error : node " << r[i].node
+                      << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (&Effect::HI(Square::SQ55, Bitboard::Zero) != master) {
+        std::cout << "Detach error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::cout << Replicas << " replicas checked by " << Threads
+              << " threads (huge pages "
+              << (Effect::hugepage() ? "advised" : "refused") << ")."
+              << std::endl;
+#else
+    // the tables are not replicated without HUGEPAGE=y
+    if (Effect::replicate(0) || Effect::attach(0) || ! Effect::attach(-1) ||
+        &Effect::HI(Square::SQ55, Bitboard::Zero) != master) {
+        std::cout << "Replica error without HUGEPAGE." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::cout << "Replicas not built (HUGEPAGE=n)." << std::endl;
+#endif
+
+    exit(EXIT_SUCCESS);
+
+}
@@ -0,0 +1,439 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <Shogi.h>
+#include <CSAFile.h>
+
+using namespace game;
+
+/* ------------------------------- parameters ------------------------------ */
+
+// Depth searched on the positions of the kifu
+static const int            Depth      = 3;
+
+// Interval of the positions searched in a kifu
+static const int            Interval   = 40;
+
+// Time to stop the endless search in milli seconds
+static const int            StopAfter  = 200;
+
+// Time allowed to return after stop() in milli seconds
+static const int            StopLimit  = 2000;
+
+// Depth searched with the pruning
+static const int            Deeper     = 5;
+
+// File of the parameters written and read
+static const char *         ParamFile  = "testsearch.param";
+
+// Number of the principal variations searched (MultiPV)
+static const int            Lines      = 3;
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* -------------------------------- types ---------------------------------- */
+
+// Search counting the lines reported
+class Reporter : public Search
+{
+
+public:
+
+    Reporter (TranspositionTable &t) : Search(t, 2), reported(0) {}
+
+    // the search in the background calls report() until it is stopped
+    ~Reporter () { stop(); wait(); }
+
+    int                     reported;
+
+protected:
+
+    void report (int, const Line &l) override
+    {
+        if (l.depth > 0 && l.nodes > 0 && l.nps > 0) {
+            ++reported;
+        }
+    }
+
+};
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/**
+ * Elapsed time in milli seconds
+ * @param s start time
+ * @return elapsed time
+ */
+static long elapsed (const struct timespec &s)
+{
+
+    struct timespec         t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (t.tv_sec - s.tv_sec) * 1000 + (t.tv_nsec - s.tv_nsec) / 1000000;
+
+}
+
+
+
+/**
+ * Thread stopping the search
+ * @param arg search
+ * @return nullptr
+ */
+static void * stopper (void *arg)
+{
+
+    usleep(StopAfter * 1000);
+    static_cast<Search *>(arg)->stop();
+
+    return nullptr;
+
+}
+
+
+
+/**
+ * Check if the moves are playable from the position
+ * @param p position
+ * @param pv moves from the position
+ * @return true if all the moves are legal
+ */
+static bool playable (const Position &p, Search::Moves &pv)
+{
+
+    Search::Moves           m;
+    Position                q(p);
+
+    for (auto move : pv) {
+        m.setsz(0);
+        q.genMove(m);
+        bool                legal = false;
+        for (auto n : m) {
+            if (n == move) {
+                legal = true;
+            }
+        }
+        if (! legal) {
+            std::cout << "Illegal PV move : " << q.string(move) << std::endl;
+            return false;
+        }
+        q.move(move);
+    }
+
+    return true;
+
+}
+
+
+
+/**
+ * Check the result of the search
+ * @param s search
+ * @param p position searched
+ * @param b best move returned
+ * @return true if the result is sane
+ */
+static bool check (Search &s, Position &p, Move::Move b)
+{
+
+    Search::Moves           m;
+    p.genMove(m);
+
+    bool                    legal = false;
+    for (auto move : m) {
+        if (move == b) {
+            legal = true;
+        }
+    }
+    if (! legal) {
+        std::cout << "Illegal best move : " << b << std::endl;
+        return false;
+    }
+    if (s.value() < -Evaluation::Infinity || s.value() > Evaluation::Infinity) {
+        std::cout << "Value error : " << s.value() << std::endl;
+        return false;
+    }
+    if (s.nodes() == 0) {
+        std::cout << "No nodes searched." << std::endl;
+        return false;
+    }
+
+    // the principal variation starts with the best move and is playable
+    Search::Moves           pv = s.pv();
+    if (pv.vsize() == 0 || pv[0] != b) {
+        std::cout << "PV error : " << pv.vsize() << std::endl;
+        return false;
+    }
+
+    return playable(p, pv);
+
+}
+
+
+
+/**
+ * Main function
+ * @param argc number of command option when invoked.
+ * @param argv strings of comannd options in array.
+ * @return status code reflecting normal end or error end.
+ */
+int main (int argc, char *argv[])
+{
+
+    // check argument
+    if (argc != 2) {
+        std::cerr << "Command Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // initialization
+    Shogi::initialize();
+
+    // set piece values
+    Position::setValue  (Evaluation::Value);
+    Position::handsValue(Evaluation::Hands);
+
+    // read kifu files
+    std::vector<std::string> kifu;
+    std::ifstream ifs(argv[1]);
+    std::string   l;
+    while (! (std::getline(ifs, l)).eof()) {
+        kifu.push_back(l);
+    }
+
+    // the searches with one and two threads, in both the schedulers,
+    // return legal moves completing the depth, and the same search object
+    // can be used repeatedly
+    TranspositionTable      t(16);
+    Search                  s1(t, 1);
+    Search                  s2(t, 2);
+    Search                  s3(t, 2, Search::YBWC);
+    if (s1.threads() != 1 || s2.threads() != 2 || s3.threads() != 2 ||
+        s3.scheduler() != Search::YBWC) {
+        std::cout << "Thread error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    int                     searched = 0;
+    for (auto &k : kifu) {
+        CSAFile f(k);
+        Position p(f.summary());
+        int                 n = 0;
+        for (auto m : f) {
+            if (n++ % Interval == 0) {
+                for (auto s : { &s1, &s2, &s3 }) {
+                    Move::Move b = s->go(p, Depth);
+                    if (! check(*s, p, b) || s->depth() != Depth) {
+                        std::cout << p << std::endl;
+                        exit(EXIT_FAILURE);
+                    }
+                }
+                ++searched;
+            }
+            p.move(m);
+        }
+    }
+    std::cout << searched << " positions searched." << std::endl;
+
+    // stop() ends the endless search promptly with the move of the last
+    // iteration completed
+    CSAFile                 f(kifu.front());
+    Position                p(f.summary());
+    pthread_t               th;
+    struct timespec         start;
+    for (auto s : { &s2, &s3 }) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        pthread_create(&th, nullptr, stopper, s);
+        Move::Move          b = s->go(p, Search::MaxPly);
+        pthread_join(th, nullptr);
+        long                e = elapsed(start);
+        std::cout << "Stopped at depth " << s->depth() << " in " << e
+                  << " ms, " << s->nodes() << " nodes." << std::endl;
+        if (! check(*s, p, b) || e > StopAfter + StopLimit) {
+            std::cout << "Stop error." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // pondering the expected move goes on when it is played, and stops
+    // promptly when another move is played
+    Search::Moves           r;
+    p.genMove(r);
+    for (auto s : { &s2, &s3 }) {
+        Position            q(p);
+        s->go(q, Depth);
+        Move::Move          e = s->best();
+        if (! s->ponder(q, e, Search::MaxPly) || s->expected() != e ||
+            s->ponderhit(e) == false || ! s->pondering()) {
+            std::cout << "Ponder hit error." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        q.move(e);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        pthread_create(&th, nullptr, stopper, s);
+        Move::Move          b = s->wait();
+        pthread_join(th, nullptr);
+        if (s->pondering() || ! check(*s, q, b) ||
+            elapsed(start) > StopAfter + StopLimit) {
+            std::cout << "Ponder error." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        Move::Move          o = r[0] != e ? r[0] : r[1];
+        s->ponder(p, e, Search::MaxPly);
+        usleep(StopAfter * 1000);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (s->ponderhit(o) || s->pondering() ||
+            elapsed(start) > StopLimit) {
+            std::cout << "Ponder miss error." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        std::cout << "Pondered to depth " << s->depth() << "." << std::endl;
+    }
+
+    // a subclass destroyed while pondering stops the search before its
+    // overrides are gone
+    for (int i = 0; i < 4; ++i) {
+        Reporter *          d = new Reporter(t);
+        if (! d->ponder(p, r[i % r.vsize()], Search::MaxPly)) {
+            std::cout << "Ponder destruction error." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        usleep(StopAfter * 1000 / 4);
+        delete d;
+    }
+    std::cout << "Destroyed while pondering." << std::endl;
+
+    // the parameters are set by the name within the ranges, and survive
+    // the file written and read again
+    Parameters              a;
+    if (! a.set("LMRBase", 100000) || a.set("NoSuchParameter", 1) ||
+        a[Parameters::LMRBase] != a.entry(Parameters::LMRBase).max ||
+        Parameters::find("RazorMargin") != Parameters::RazorMargin) {
+        std::cout << "Parameter error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    a.set(Parameters::MultiCutDepth, 2);
+    a.set(Parameters::FutilityMargin, 123);
+    a.save(ParamFile);
+    Parameters              b;
+    b.load(ParamFile);
+    unlink(ParamFile);
+    for (int i = 0; i < Parameters::Size; ++i) {
+        auto                x = static_cast<Parameters::Index>(i);
+        if (a[x] != b[x]) {
+            std::cout << "Parameter file error : " << a.entry(x).name
+                      << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // a malformed file changes none of the parameters
+    {
+        std::ofstream       ofs(ParamFile);
+        ofs << "FutilityMargin 1" << std::endl
+            << "RazorMargin"      << std::endl;
+    }
+    bool                    malformed = false;
+    try {
+        b.load(ParamFile);
+    } catch (ParametersIOException &) {
+    } catch (ParametersException &) {
+        malformed = true;
+    }
+    unlink(ParamFile);
+    if (! malformed || b[Parameters::FutilityMargin] != 123) {
+        std::cout << "Parameter format error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // the pruning cuts the nodes, and any of the techniques turned on
+    // deep or shallow keeps the moves legal
+    Search                  s4(t, 1);
+    uint64_t                pruned;
+    t.clear();
+    s4.go(p, Deeper);
+    pruned = s4.nodes();
+    s4.parameters().set(Parameters::LMRBase       ,  0);
+    s4.parameters().set(Parameters::LMRScale      ,  0);
+    s4.parameters().set(Parameters::FutilityDepth ,  0);
+    s4.parameters().set(Parameters::RazorDepth    ,  0);
+    s4.parameters().set(Parameters::MultiCutDepth , Search::MaxPly + 1);
+    t.clear();
+    s4.go(p, Deeper);
+    std::cout << "Nodes at depth " << Deeper << " : " << pruned
+              << " pruned, " << s4.nodes() << " not pruned." << std::endl;
+    if (pruned >= s4.nodes()) {
+        std::cout << "Pruning error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    s4.parameters() = a;
+    for (auto &k : kifu) {
+        CSAFile g(k);
+        Position q(g.summary());
+        int                 n = 0;
+        for (auto m : g) {
+            if (n++ % Interval == Interval / 2) {
+                Move::Move  c = s4.go(q, Deeper);
+                if (! check(s4, q, c)) {
+                    std::cout << q << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            q.move(m);
+        }
+    }
+
+    // the lines of MultiPV start with the distinct moves, the best one is
+    // of the best move and the others follow in the order of the values,
+    // and each of them is reported as found
+    Reporter                s5(t);
+    s5.multiPV(Lines);
+    for (auto &k : kifu) {
+        CSAFile g(k);
+        Position q(g.summary());
+        int                 n = 0;
+        for (auto m : g) {
+            if (n++ % Interval == 0) {
+                Search::Moves r;
+                q.genMove(r);
+                s5.reported = 0;
+                Move::Move  c = s5.go(q, Depth);
+                int         l = std::min(Lines, static_cast<int>(r.vsize()));
+                if (! check(s5, q, c) || s5.lines() != l ||
+                    s5.reported != l * Depth ||
+                    s5.line(0).pv[0] != c || s5.line(0).value != s5.value()) {
+                    std::cout << "MultiPV error : " << s5.lines() << " "
+                              << s5.reported << std::endl << q << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+                for (int i = 0; i < l; ++i) {
+                    Search::Line  x = s5.line(i);
+                    bool          e = x.depth != Depth || x.nodes == 0 ||
+                                      ! playable(q, x.pv);
+                    for (int j = 0; j < i; ++j) {
+                        e = e || s5.line(j).pv[0] == x.pv[0] ||
+                                 (j > 0 && s5.line(j).value < x.value);
+                    }
+                    if (e) {
+                        std::cout << "MultiPV line error : " << i
+                                  << std::endl << q << std::endl;
+                        exit(EXIT_FAILURE);
+                    }
+                }
+            }
+            q.move(m);
+        }
+    }
+
+    exit(EXIT_SUCCESS);
+
+}
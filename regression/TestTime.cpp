@@ -0,0 +1,197 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <Shogi.h>
+#include <CSAFile.h>
+
+using namespace game;
+
+/* ------------------------------- parameters ------------------------------ */
+
+// Time to sleep in milli seconds
+static const long           Sleep      = 100;
+
+// Time allowed for the search to end its iteration in milli seconds
+static const long           IterationLimit = 10000;
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/**
+ * Thread telling the search not to start a new iteration
+ * @param arg search
+ * @return nullptr
+ */
+static void * stopper (void *arg)
+{
+
+    usleep(Sleep * 1000);
+    static_cast<Search *>(arg)->stopNext();
+
+    return nullptr;
+
+}
+
+
+
+/**
+ * Report the error and exit
+ * @param s error message
+ */
+static void error (const char *s)
+{
+
+    std::cout << s << std::endl;
+    exit(EXIT_FAILURE);
+
+}
+
+
+
+/**
+ * Main function
+ * @param argc number of command option when invoked.
+ * @param argv strings of comannd options in array.
+ * @return status code reflecting normal end or error end.
+ */
+int main (int argc, char *argv[])
+{
+
+    // check argument
+    if (argc != 2) {
+        std::cerr << "Command Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // initialization
+    Shogi::initialize();
+
+    // set piece values
+    Position::setValue  (Evaluation::Value);
+    Position::handsValue(Evaluation::Hands);
+
+    // read kifu files
+    std::vector<std::string> kifu;
+    std::ifstream ifs(argv[1]);
+    std::string   l;
+    while (! (std::getline(ifs, l)).eof()) {
+        kifu.push_back(l);
+    }
+
+    // the game summary is read in its unit, 10 minutes and 10 seconds of
+    // byoyomi in seconds
+    CSASummary              g;
+    g.unit        = 1;
+    g.timeUnit    = CSASummary::SECOND;
+    g.totalTime   = 600;
+    g.byoyomi     = 10;
+    g.increment   = 0;
+    g.delay       = 0;
+    g.leastTime   = 0;
+    g.timeRoundup = "NO";
+    TimeManager             t(g);
+    t.start();
+    if (t.remaining() != 600000 ||
+        t.softLimit() != 600000 / TimeManager::MovesToGo + 10000 ||
+        t.hardLimit() != t.softLimit() * TimeManager::HardRatio) {
+        error("Summary error.");
+    }
+
+    // the changes of the best move extend the soft limit up to the hard
+    // limit, and not in the shallow iterations
+    long                    s = t.softLimit();
+    t.update(static_cast<Move::Move>(1), 1);
+    t.update(static_cast<Move::Move>(2), 1);
+    if (t.softLimit() != s) {
+        error("Shallow extension error.");
+    }
+    t.update(static_cast<Move::Move>(1), TimeManager::StableDepth);
+    if (t.softLimit() != s + s * TimeManager::Extension / 100) {
+        error("Extension error.");
+    }
+    for (int i = 0; i < 100; ++i) {
+        t.update(static_cast<Move::Move>(i + 3), TimeManager::StableDepth);
+    }
+    if (t.softLimit() > t.hardLimit()) {
+        error("Extension limit error.");
+    }
+
+    // the clock runs, and the time spent is charged truncated to the unit
+    usleep(Sleep * 1000);
+    if (t.elapsed() < Sleep || t.soft() || t.hard()) {
+        error("Clock error.");
+    }
+    if (t.finish() != 0 || t.remaining() != 600000) {
+        error("Charge error.");
+    }
+
+    // the time the server charged replaces the time measured
+    t.charge(30);
+    if (t.remaining() != 570000) {
+        error("Server charge error.");
+    }
+
+    // the time over the time left is paid by the byoyomi, and the moves
+    // in the byoyomi use it all but the margin
+    t.charge(700);
+    t.start();
+    if (t.remaining() != 0 || t.hardLimit() != 10000 - TimeManager::Margin ||
+        t.softLimit() != t.hardLimit()) {
+        error("Byoyomi error.");
+    }
+
+    // the increment is added after the move, the least time is charged at
+    // least, and the time is rounded up when told
+    t.set(60000, 0, 5000, 0, 2000, true, 1000);
+    t.start();
+    if (t.finish() != 2000 || t.remaining() != 63000) {
+        error("Increment error.");
+    }
+    t.set(60000, 0, 0, 0, 0, true, 1000);
+    t.start();
+    usleep(Sleep * 1000);
+    if (t.finish() != 1000 || t.remaining() != 59000) {
+        error("Roundup error.");
+    }
+
+    // the delay covers the margin, and the hard limit never passes the
+    // time left
+    t.set(1000, 0, 0, TimeManager::Margin, 0, false, 1000);
+    t.start();
+    if (t.hardLimit() > 1000) {
+        error("Delay error.");
+    }
+
+    // no time control has unbounded limits
+    TimeManager             u;
+    u.start();
+    if (u.soft() || u.hard()) {
+        error("No control error.");
+    }
+
+    // the search told to stop at the next iteration completes the one
+    // searching, and returns
+    TranspositionTable      tt(16);
+    Search                  search(tt, 1);
+    CSAFile                 f(kifu.front());
+    Position                p(f.summary());
+    pthread_t               th;
+    t.set(0, 0);
+    t.start();
+    pthread_create(&th, nullptr, stopper, &search);
+    search.go(p, Search::MaxPly);
+    pthread_join(th, nullptr);
+    std::cout << "Stopped at depth " << search.depth() << " in "
+              << t.elapsed() << " ms." << std::endl;
+    if (search.depth() == 0 || t.elapsed() > IterationLimit) {
+        error("Iteration error.");
+    }
+
+    exit(EXIT_SUCCESS);
+
+}
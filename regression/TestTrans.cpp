@@ -0,0 +1,400 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#include <Shogi.h>
+#include <CSAFile.h>
+
+using namespace game;
+
+/* ------------------------------- parameters ------------------------------ */
+
+// Number of threads racing on the table
+static const int            Threads    = 4;
+
+// Number of operations per thread
+static const int            Operations = 2000000;
+
+/* ------------------------------------------------------------------------- */
+
+
+
+/* --------------------------- global  variables --------------------------- */
+
+// Table shared by the threads (small enough to make them collide)
+static TranspositionTable * _table     = nullptr;
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Values derived from the key
+ * Every hit must carry exactly these values, whoever stored the entry.
+ */
+static Move::Move       moveOf  (Zobrist::key k) {
+                            return static_cast<Move::Move>(k & 0x7fff);
+                        }
+static Evaluation::Eval valueOf (Zobrist::key k) {
+                            return static_cast<int>((k >> 16) % 20000) - 10000;
+                        }
+static Evaluation::Eval evalOf  (Zobrist::key k) {
+                            return static_cast<int>((k >> 32) % 20000) - 10000;
+                        }
+static int              depthOf (Zobrist::key k) {
+                            return static_cast<int>((k >> 48) % 128);
+                        }
+
+
+
+/**
+ * Check the entry against the key
+ * @param k hash key
+ * @param e entry found
+ * @return true if the entry is consistent
+ */
+static bool consistent (Zobrist::key k, const TranspositionTable::Entry &e)
+{
+
+    return e.move () == moveOf (k) && e.value() == valueOf(k) &&
+           e.eval () == evalOf (k) && e.depth() == depthOf(k) &&
+           e.bound() == TranspositionTable::Exact;
+
+}
+
+
+
+/**
+ * Store the key
+ * @param t table
+ * @param k hash key
+ */
+static void record (TranspositionTable &t, Zobrist::key k)
+{
+
+    t.store(k, moveOf(k), valueOf(k), evalOf(k), depthOf(k),
+            TranspositionTable::Exact);
+
+}
+
+
+
+/**
+ * Callback of the moves taking the new key
+ * @param p position after the move
+ * @param arg key to be filled
+ */
+static void hooked (const Position &p, void *arg)
+{
+
+    *static_cast<Zobrist::key *>(arg) = p.hash();
+
+}
+
+
+
+/**
+ * Thread storing and probing random keys on the shared table
+ * @param arg seed of the keys
+ * @return number of inconsistent hits
+ */
+static void * race (void *arg)
+{
+
+    uint64_t                x    = reinterpret_cast<uintptr_t>(arg);
+    uintptr_t               bad  = 0;
+    TranspositionTable::Entry e;
+
+    for (int i = 0; i < Operations; ++i) {
+        // xorshift
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        // a small key space makes the threads hit each others entries
+        Zobrist::key k = (x & 0xfff) * 0x9e3779b97f4a7c15ULL;
+        if (i & 1) {
+            record(*_table, k);
+        } else
+        if (_table->probe(k, e) && ! consistent(k, e)) {
+            ++bad;
+        }
+    }
+
+    return reinterpret_cast<void *>(bad);
+
+}
+
+
+
+/**
+ * Main function
+ * @param argc number of command option when invoked.
+ * @param argv strings of comannd options in array.
+ * @return status code reflecting normal end or error end.
+ */
+int main (int argc, char *argv[])
+{
+
+    // check argument
+    if (argc != 2) {
+        std::cerr << "Command Error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // initialization
+    Shogi::initialize();
+
+    // set piece values
+    Position::setValue  (Evaluation::Value);
+    Position::handsValue(Evaluation::Hands);
+
+    // positions in the kifu files
+    TranspositionTable      t(16);
+    TranspositionTable::Entry e;
+    std::ifstream ifs(argv[1]);
+    std::string   l;
+    while (! (std::getline(ifs, l)).eof()) {
+        CSAFile f(l);
+        Position p(f.summary());
+        Zobrist::key h = 0;
+        p.hook(hooked, &h);
+        for (auto m : f) {
+            auto k = p.hash();
+            // the entry stored is found as it is
+            record(t, k);
+            if (! t.probe(k, e) || ! consistent(k, e)) {
+                std::cout << "Probe error : " << std::endl
+                          << p << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            // the secondary key verifies the entry in place of the key
+            t.store(k, p.verifier(), moveOf(k), valueOf(k), evalOf(k),
+                    depthOf(k), TranspositionTable::Exact);
+            if (! t.probe(k, p.verifier(), e) || ! consistent(k, e)) {
+                std::cout << "Verifier error : " << std::endl
+                          << p << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            p.move(m);
+            // the callback is fired with the new key
+            if (h != p.hash()) {
+                std::cout << "Hook error : " << std::endl
+                          << p << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+        // age the entries
+        t.newSearch();
+    }
+
+    // the entry of the same position is not replaced by a shallower one
+    Zobrist::key            k = 0x0123456789abcdefULL;
+    t.store(k, moveOf(k), 100, 0, 20, TranspositionTable::Exact);
+    t.store(k, Move::None, 200, 0, 10, TranspositionTable::Lower);
+    if (! t.probe(k, e) || e.value() != 100 || e.depth() != 20) {
+        std::cout << "Replacement error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    // but the move is kept when it is updated
+    t.store(k, Move::None, 300, 0, 30, TranspositionTable::Lower);
+    if (! t.probe(k, e) || e.value() != 300 || e.move() != moveOf(k)) {
+        std::cout << "Replacement error." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // the entries of the previous generations are not counted
+    TranspositionTable      u(64);
+    for (Zobrist::key i = 1; i <= u.clusters(); ++i) {
+        record(u, i * 0x9e3779b97f4a7c15ULL);
+    }
+    int                     full = u.hashfull();
+    u.newSearch();
+    if (full < 200 || u.hashfull() != 0) {
+        std::cout << "Hashfull error : " << full << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // the table cleared by the threads is empty
+    u.clear(Threads);
+    for (Zobrist::key i = 1; i <= u.clusters(); ++i) {
+        if (u.probe(i * 0x9e3779b97f4a7c15ULL, e)) {
+            std::cout << "Clear error." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // the entries in the file survive the table
+    const char *            path = "testtrans.tt";
+    remove(path);
+    {
+        TranspositionTable  f(1);
+        if (f.open(path, 4)) {
+            std::cout << "Open error : new file taken over." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        for (Zobrist::key i = 1; i <= 10000; ++i) {
+            record(f, i * 0x9e3779b97f4a7c15ULL);
+        }
+        f.newSearch();
+        // the file is locked while it is mapped
+        TranspositionTable  g(1);
+        bool                locked = false;
+        try {
+            g.open(path);
+        } catch (TranspositionTableException &) {
+            locked = true;
+        }
+        if (! locked) {
+            std::cout << "Open error : file not locked." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        f.sync();
+    }
+    {
+        TranspositionTable  f(1);
+        if (! f.open(path) || f.generation() != 1) {
+            std::cout << "Open error : file not taken over." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        size_t              hit = 0;
+        for (Zobrist::key i = 1; i <= 10000; ++i) {
+            Zobrist::key    h = i * 0x9e3779b97f4a7c15ULL;
+            if (f.probe(h, e)) {
+                if (! consistent(h, e)) {
+                    std::cout << "Open error : broken entry." << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+                ++hit;
+            }
+        }
+        if (hit < 9000) {
+            std::cout << "Open error : " << hit << " hits." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    // the file of another version is discarded
+    {
+        std::fstream        fs(path, std::ios::in | std::ios::out |
+                                     std::ios::binary);
+        uint32_t            v = 0xffffffff;
+        fs.seekp(8);
+        fs.write(reinterpret_cast<const char *>(&v), sizeof(v));
+    }
+    {
+        TranspositionTable  f(1);
+        if (f.open(path) || f.probe(1 * 0x9e3779b97f4a7c15ULL, e)) {
+            std::cout << "Open error : old file taken over." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    remove(path);
+
+    // processes sharing the table see the entries of each other
+    const char *            name = "/testtrans";
+    TranspositionTable::unshare(name);
+    {
+        TranspositionTable  f(1);
+        if (f.share(name, 4)) {
+            std::cout << "Share error : new object taken over." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        pid_t               pid = fork();
+        if (pid == 0) {
+            TranspositionTable c(1);
+            if (! c.share(name) || c.clusters() != f.clusters()) {
+                _exit(EXIT_FAILURE);
+            }
+            for (Zobrist::key i = 0x1000; i < 0x1000 + 10000; ++i) {
+                record(c, i * 0x9e3779b97f4a7c15ULL);
+            }
+            _table = &c;
+            _exit(race(reinterpret_cast<void *>(0x7654321ULL)) == nullptr ?
+                                                EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        _table = &f;
+        uintptr_t           torn = reinterpret_cast<uintptr_t>(
+                                race(reinterpret_cast<void *>(0x1234567ULL)));
+        int                 status;
+        if (pid < 0 || waitpid(pid, &status, 0) != pid ||
+            ! WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS ||
+            torn != 0) {
+            std::cout << "Share error : inconsistent entries." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        size_t              hit = 0;
+        for (Zobrist::key i = 0x1000; i < 0x1000 + 10000; ++i) {
+            Zobrist::key    h = i * 0x9e3779b97f4a7c15ULL;
+            if (f.probe(h, e)) {
+                if (! consistent(h, e)) {
+                    std::cout << "Share error : broken entry." << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+                ++hit;
+            }
+        }
+        if (hit < 9000) {
+            std::cout << "Share error : " << hit << " hits." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        // an object of another build is refused, and left as it is for the
+        // processes using it
+        int                 fd = shm_open(name, O_RDWR, 0600);
+        char                magic;
+        struct stat         st0;
+        struct stat         st1;
+        bool                refused = false;
+        if (fd < 0 || fstat(fd, &st0) != 0 ||
+            pread(fd, &magic, 1, 0) != 1) {
+            std::cout << "Share error : object lost." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        char                other = static_cast<char>(magic ^ 0x20);
+        pwrite(fd, &other, 1, 0);
+        try {
+            TranspositionTable o(1);
+            o.share(name);
+        } catch (TranspositionTableException &) {
+            refused = true;
+        }
+        pwrite(fd, &magic, 1, 0);
+        fstat(fd, &st1);
+        ::close(fd);
+        size_t              kept = 0;
+        for (Zobrist::key i = 0x1000; i < 0x1000 + 10000; ++i) {
+            if (f.probe(i * 0x9e3779b97f4a7c15ULL, e)) {
+                ++kept;
+            }
+        }
+        if (! refused || st1.st_size != st0.st_size || kept != hit) {
+            std::cout << "Share error : foreign object reformatted."
+                      << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    TranspositionTable::unshare(name);
+
+    // racing threads never see torn entries
+    TranspositionTable      s(1);
+    pthread_t               th[Threads];
+    uintptr_t               bad = 0;
+    _table = &s;
+    for (int i = 0; i < Threads; ++i) {
+        pthread_create(&th[i], nullptr, race,
+                       reinterpret_cast<void *>(0x1234567ULL * (i + 1)));
+    }
+    for (int i = 0; i < Threads; ++i) {
+        void *              r;
+        pthread_join(th[i], &r);
+        bad += reinterpret_cast<uintptr_t>(r);
+    }
+    if (bad != 0) {
+        std::cout << "Inconsistent entries : " << bad << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    exit(EXIT_SUCCESS);
+
+}
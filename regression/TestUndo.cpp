@@ -56,6 +56,16 @@ int main (int argc, char *argv[])
             _p.minorMove(move);
             for (auto _m : move) {
                 auto back = _p.move(_m);
+#ifdef USE_SUBHASHKEY
+                if (! _p.chkHash()) {
+                    _p.show(_m);
+                    std::cout << std::endl
+                              << "Sub Hash Error."
+                              << std::endl
+                              << _p << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+#endif
                 _p.undo(back);
                 if (p.hash() != _p.hash()) {
                     _p.show(_m);
@@ -65,6 +75,16 @@ int main (int argc, char *argv[])
                               <<  p << std::endl
                               << _p << std::endl;
                 }
+                if (p.hashPawn() != _p.hashPawn() ||
+                    p.hashKing(Color::Black) != _p.hashKing(Color::Black) ||
+                    p.hashKing(Color::White) != _p.hashKing(Color::White)) {
+                    _p.show(_m);
+                    std::cout << std::endl
+                              << "Sub Hash Error."
+                              << std::endl
+                              << _p << std::endl;
+                    exit(EXIT_FAILURE);
+                }
                 if (p != _p) {
                     _p.show(_m);
                     std::cout << std::endl
@@ -72,6 +92,20 @@ int main (int argc, char *argv[])
                               << _p << std::endl;
                     exit(EXIT_FAILURE);
                 }
+#ifdef USE_ATTACKCOUNTMAP
+                for (auto c : Color::all) {
+                    for (auto sq : Square::all) {
+                        if (p.attackers(c, sq) != _p.attackers(c, sq)) {
+                            _p.show(_m);
+                            std::cout << std::endl
+                                      << "Count Error."
+                                      << std::endl
+                                      << _p << std::endl;
+                            exit(EXIT_FAILURE);
+                        }
+                    }
+                }
+#endif
             }
             //
             key[index] = p.hash();
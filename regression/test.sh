@@ -107,3 +107,66 @@ else
     echo NG
     exit 1
 fi
+
+echo "TEST TRANS  :"
+if time ./testtrans kifulist
+then
+    echo OK
+else
+    echo NG
+    exit 1
+fi
+
+echo "TEST HAND   :"
+if time ./testhand kifulist
+then
+    echo OK
+else
+    echo NG
+    exit 1
+fi
+
+echo "TEST CACHE  :"
+if time ./testcache kifulist
+then
+    echo OK
+else
+    echo NG
+    exit 1
+fi
+
+echo "TEST SEARCH :"
+if time ./testsearch kifulist
+then
+    echo OK
+else
+    echo NG
+    exit 1
+fi
+
+echo "TEST HISTORY:"
+if time ./testhistory kifulist
+then
+    echo OK
+else
+    echo NG
+    exit 1
+fi
+
+echo "TEST TIME   :"
+if time ./testtime kifulist
+then
+    echo OK
+else
+    echo NG
+    exit 1
+fi
+
+echo "TEST REPLICA:"
+if time ./testreplica
+then
+    echo OK
+else
+    echo NG
+    exit 1
+fi